@@ -30,7 +30,7 @@ Defined by this header:
 **man-end****************************************************************/
 
 #define PDCURSES        1
-#define PDC_BUILD    3908
+#define PDC_BUILD    3909
 #define PDC_VER_MAJOR   3
 #define PDC_VER_MINOR   9
 #define PDC_VERDOT   "3.9"
@@ -126,9 +126,46 @@ enum
     PDC_VFLAG_WIDE  = 2,  /* -DPDC_WIDE */
     PDC_VFLAG_UTF8  = 4,  /* -DPDC_FORCE_UTF8 */
     PDC_VFLAG_DLL   = 8,  /* -DPDC_DLL_BUILD */
-    PDC_VFLAG_RGB   = 16  /* -DPDC_RGB */
+    PDC_VFLAG_RGB   = 16, /* -DPDC_RGB */
+    PDC_VFLAG_STATS = 32  /* -DPDCSTATS */
 };
 
+/* Rendering counters, from PDC_get_stats(); kept only when the library
+   is built with -DPDCSTATS */
+
+typedef struct
+{
+    unsigned long updates;        /* doupdate() calls */
+    unsigned long lines_examined; /* lines checked for changes by
+                                     doupdate() and wnoutrefresh() */
+    unsigned long cells_compared; /* cells they compared */
+    unsigned long runs;           /* runs passed to the platform */
+    unsigned long cells_drawn;    /* cells in those runs */
+    unsigned long packets;        /* runs of one attribute drawn */
+    unsigned long blits;          /* blocks moved on the screen */
+    unsigned long presents;       /* updates shown by the platform */
+    unsigned long diff_us;        /* microseconds finding the changed
+                                     lines, */
+    unsigned long render_us;      /* drawing them, */
+    unsigned long present_us;     /* and showing them */
+    unsigned long bytes_copied;   /* bytes of cells copied */
+} PDC_STATS;
+
+/* Input-to-screen latency, from PDC_get_latency(): the time from a
+   key's arrival to the next update shown. Bucket i counts times from
+   2^i up to 2^(i+1) microseconds; the last also takes everything
+   longer. */
+
+#define PDC_LATENCY_BUCKETS 24
+
+typedef struct
+{
+    unsigned long count;          /* keys measured */
+    unsigned long total_us;       /* their total latency */
+    unsigned long max_us;         /* and the longest */
+    unsigned long bucket[PDC_LATENCY_BUCKETS];
+} PDC_LATENCY;
+
 /*----------------------------------------------------------------------
  *
  *  Mouse Interface
@@ -250,7 +287,8 @@ typedef struct
 typedef struct
 {
     short id;       /* unused, always 0 */
-    int x, y, z;    /* x, y same as MOUSE_STATUS; z unused */
+    int x, y, z;    /* x, y same as MOUSE_STATUS; z unused, unless
+                       PDC_report_mouse_count() is set */
     mmask_t bstate; /* equivalent to changes + button[], but
                        in the same format as used for mousemask() */
 } MEVENT;
@@ -276,6 +314,17 @@ typedef struct
  *
  */
 
+/* Per-cell data that doesn't fit in a chtype, kept in a "side plane"
+   parallel to a window's lines, once something needs it */
+
+typedef struct
+{
+    int   pair;           /* extended color pair, for a cell with no
+                             A_COLOR; 0 for none */
+    int   f;              /* direct colors from wrgb_set(): each a */
+    int   b;              /*   PDC_RGB_COLOR() value, or 0 for none */
+} PDC_SIDE;
+
 typedef struct _win       /* definition of a window */
 {
     int   _cury;          /* current pseudo-cursor */
@@ -313,18 +362,38 @@ typedef struct _win       /* definition of a window */
         int _pad_bottom;
         int _pad_right;
     } _pad;               /* Pad-properties structure */
+
+    PDC_SIDE **_side;     /* side plane, parallel to _y; NULL until
+                             first needed */
+    PDC_SIDE _sideattr;   /* side cell for characters written now */
 } WINDOW;
 
-/* Color pair structure */
+/* Color pair structure. Its layout differs from that of build 3908,
+   which had only f, b, count and set: prev through hhead are new. Code
+   that reads SP->atrtab directly must be rebuilt against this header. */
 
 typedef struct
 {
     short f;              /* foreground color */
     short b;              /* background color */
-    int   count;          /* allocation order */
+    int   count;          /* allocation order; renewed whenever the
+                             colors change, so renderers can cache */
+    int   prev;           /* allocation list: free pairs first, then set */
+    int   next;           /*   pairs, least recently used first; 0 is
+                             the head */
+    int   hnext;          /* next pair with the same (f, b) hash */
+    int   hhead;          /* first pair in hash bucket of this index */
     bool  set;            /* pair has been set */
 } PDC_PAIR;
 
+/* Cell write, for waddcells() */
+
+typedef struct
+{
+    int   y, x;           /* window coordinates */
+    chtype ch;            /* character and attributes to store */
+} PDC_CELL;
+
 /* Avoid using the SCREEN struct directly -- use the corresponding
    functions if possible. This struct may eventually be made private. */
 
@@ -385,6 +454,35 @@ typedef struct
     int   c_ungind;       /* ungetch() push index */
     int   c_ungmax;       /* allocated size of ungetch() buffer */
     PDC_PAIR *atrtab;     /* table of color pairs */
+    int   batch_depth;    /* PDC_begin_batch() nesting level */
+    WINDOW **batch_wins;  /* windows with deferred syncs */
+    int   batch_count;    /* number of entries in batch_wins */
+    int   batch_max;      /* allocated size of batch_wins */
+    WINDOW **win_list;    /* every window, for PDC_side_enable() */
+    int   win_count;      /* number of entries in win_list */
+    int   win_max;        /* allocated size of win_list */
+    bool  side_plane;     /* windows have side planes */
+    unsigned char *pair_map;  /* per-line bitmaps of the pairs in
+                                 lastscr, built on demand */
+    bool *pair_map_ok;    /* pair_map line is up to date */
+    int   pair_map_lines; /* number of lines in pair_map */
+    bool  rgb_color;      /* backend can draw PDC_RGB_COLOR() colors */
+    int   mouse_count;    /* device events merged into mouse_status */
+    bool  report_mouse_count;  /* TRUE if nc_getmouse() returns
+                                  mouse_count in z */
+    bool  paste_mode;     /* TRUE if pastes come as one KEY_PASTE */
+    char *paste_buf;      /* text of the last KEY_PASTE */
+    long  paste_len;      /* its length in bytes */
+    bool  trace_on;       /* TRUE if binary tracing is on */
+    PDC_STATS stats;      /* counters for PDC_get_stats() */
+    int   replay_frames;  /* frames to run in replay mode, or 0 */
+    unsigned long key_time;  /* when the platform got the key being
+                                returned, in us, or 0 if unknown */
+    unsigned long key_mark;  /* when the oldest key not yet shown
+                                arrived */
+    bool  key_pending;    /* TRUE if key_mark is set */
+    bool  latency_overlay;  /* show the latency on screen (debug) */
+    PDC_LATENCY latency;  /* histogram for PDC_get_latency() */
 } SCREEN;
 
 /*----------------------------------------------------------------------
@@ -631,6 +729,13 @@ indicator.
 
 #define COLOR_WHITE   7
 
+/* 24-bit colors, for wrgb_set(), where PDC_has_rgb_color() is TRUE */
+
+#define PDC_COLOR_DIRECT  0x1000000L
+
+#define PDC_RGB_COLOR(r, g, b) ((int)(PDC_COLOR_DIRECT | \
+    ((long)((r) & 0xff) << 16) | (((g) & 0xff) << 8) | ((b) & 0xff)))
+
 /*----------------------------------------------------------------------
  *
  *  Function and Keypad Key Definitions
@@ -881,9 +986,11 @@ indicator.
 #define KEY_RESIZE    0x222  /* Window resize */
 #define KEY_SUP       0x223  /* Shifted up arrow */
 #define KEY_SDOWN     0x224  /* Shifted down arrow */
+#define KEY_PASTE     0x225  /* Bracketed paste; see
+                                PDC_get_paste_buffer() */
 
 #define KEY_MIN       KEY_BREAK      /* Minimum curses key value */
-#define KEY_MAX       KEY_SDOWN      /* Maximum curses key */
+#define KEY_MAX       KEY_PASTE      /* Maximum curses key */
 
 #define KEY_F(n)      (KEY_F0 + (n))
 
@@ -1298,9 +1405,11 @@ PDCEX  mmask_t getmouse(void);
 PDCEX  int     alloc_pair(int, int);
 PDCEX  int     assume_default_colors(int, int);
 PDCEX  const char *curses_version(void);
+PDCEX  int     extended_pair_content(int, int *, int *);
 PDCEX  int     find_pair(int, int);
 PDCEX  int     free_pair(int);
 PDCEX  bool    has_key(int);
+PDCEX  int     init_extended_pair(int, int, int);
 PDCEX  bool    is_cleared(const WINDOW *);
 PDCEX  bool    is_idcok(const WINDOW *);
 PDCEX  bool    is_idlok(const WINDOW *);
@@ -1345,16 +1454,33 @@ PDCEX  int     mvwinsrawch(WINDOW *, int, int, chtype);
 PDCEX  int     raw_output(bool);
 PDCEX  int     resize_term(int, int);
 PDCEX  WINDOW *resize_window(WINDOW *, int, int);
+PDCEX  int     waddcells(WINDOW *, const PDC_CELL *, int);
+PDCEX  int     waddchrect(WINDOW *, int, int, int, int, const chtype *,
+                           int);
 PDCEX  int     waddrawch(WINDOW *, chtype);
+PDCEX  int     winrgb(WINDOW *, int *, int *);
 PDCEX  int     winsrawch(WINDOW *, chtype);
 PDCEX  char    wordchar(void);
+PDCEX  int     wrgb_get(WINDOW *, int *, int *);
+PDCEX  int     wrgb_set(WINDOW *, int, int);
 
 #ifdef PDC_WIDE
 PDCEX  wchar_t *slk_wlabel(int);
 #endif
 
+PDCEX  int     PDC_begin_batch(void);
 PDCEX  void    PDC_debug(const char *, ...);
+PDCEX  int     PDC_trace_start(int);
+PDCEX  int     PDC_trace_stop(void);
+PDCEX  int     PDC_trace_dump(const char *);
+PDCEX  int     PDC_end_batch(void);
+PDCEX  int     PDC_get_latency(PDC_LATENCY *, bool);
+PDCEX  int     PDC_get_stats(PDC_STATS *, bool);
+PDCEX  int     PDC_play_input(const char *, bool);
+PDCEX  int     PDC_record_input(const char *);
+PDCEX  int     PDC_record_screen(const char *);
 PDCEX  void    PDC_get_version(PDC_VERSION *);
+PDCEX  bool    PDC_has_rgb_color(void);
 PDCEX  int     PDC_ungetch(int);
 PDCEX  int     PDC_set_blink(bool);
 PDCEX  int     PDC_set_bold(bool);
@@ -1368,6 +1494,10 @@ PDCEX  int     PDC_setclipboard(const char *, long);
 
 PDCEX  unsigned long PDC_get_key_modifiers(void);
 PDCEX  int     PDC_return_key_modifiers(bool);
+PDCEX  int     PDC_post_key(int);
+PDCEX  int     PDC_set_paste_mode(bool);
+PDCEX  const char *PDC_get_paste_buffer(long *);
+PDCEX  int     PDC_report_mouse_count(bool);
 
 #ifdef XCURSES
 PDCEX  WINDOW *Xinitscr(int, char **);
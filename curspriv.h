@@ -40,6 +40,8 @@ typedef struct           /* structure for ripped off lines */
 #define _SUBWIN    0x01  /* window is a subwindow */
 #define _PAD       0x10  /* X/Open Pad. */
 #define _SUBPAD    0x20  /* X/Open subpad. */
+#define _BATCHED   0x40  /* sync deferred until PDC_end_batch() */
+#define _TOUCHED   0x80  /* every line touched, by touchwin() */
 
 /* Miscellaneous */
 
@@ -57,6 +59,7 @@ void    PDC_beep(void);
 bool    PDC_can_change_color(void);
 int     PDC_color_content(short, short *, short *, short *);
 bool    PDC_check_key(void);
+bool    PDC_copy_area(int, int, int, int, int, int);
 int     PDC_curs_set(int);
 void    PDC_doupdate(void);
 void    PDC_flushinp(void);
@@ -68,6 +71,7 @@ void    PDC_gotoyx(int, int);
 bool    PDC_has_mouse(void);
 int     PDC_init_color(short, short, short, short);
 int     PDC_modifiers_set(void);
+unsigned long PDC_ms_count(void);
 int     PDC_mouse_set(void);
 void    PDC_napms(int);
 void    PDC_reset_prog_mode(void);
@@ -83,17 +87,29 @@ void    PDC_scr_free(void);
 int     PDC_scr_open(void);
 void    PDC_set_keyboard_binary(bool);
 void    PDC_transform_line(int, int, int, const chtype *);
+bool    PDC_wait_key(int *);
+void    PDC_wakeup(void);
 const char *PDC_sysname(void);
+unsigned long PDC_us_count(void);
 
 /* Internal cross-module functions */
 
+void    PDC_expand_touch(WINDOW *);
 void    PDC_init_atrtab(void);
+bool    PDC_key_posted(void);
 WINDOW *PDC_makelines(WINDOW *);
 WINDOW *PDC_makenew(int, int, int, int);
 int     PDC_mouse_in_slk(int, int);
+void    PDC_move_hint(int, int, int, int, int, int);
+int     PDC_opts_pair(short, const void *);
+void    PDC_pair_changed(int);
+void    PDC_replay_start(int);
+void    PDC_show_selection(int, int);
+bool    PDC_side_enable(void);
 void    PDC_slk_free(void);
 void    PDC_slk_initialize(void);
 void    PDC_sync(WINDOW *);
+void    PDC_trace(int, long, long, long);
 
 #ifdef PDC_WIDE
 int     PDC_mbtowc(wchar_t *, const char *, size_t);
@@ -107,6 +123,61 @@ size_t  PDC_wcstombs(char *, const wchar_t *, size_t);
 # define PDC_LOG(x)
 #endif
 
+/* Events for the binary trace; their names are in debug.c */
+
+enum
+{
+    PDC_EV_DOUPDATE,        /* clearall */
+    PDC_EV_LINE,            /* y, x, length drawn */
+    PDC_EV_DOUPDATE_END,
+    PDC_EV_WAIT,            /* ms to wait */
+    PDC_EV_WAIT_END,        /* ms left, input found */
+    PDC_EV_KEY,             /* key returned by wgetch(), key_code */
+    PDC_EV_POST_KEY,        /* key, OK or ERR */
+    PDC_EV_NAPMS,           /* ms */
+    PDC_EV_RESIZE,          /* lines, cols */
+    PDC_EV_PAIR_CHANGED,    /* pair */
+    PDC_EV_WNOUTREFRESH,    /* begy, begx, lines */
+    PDC_EV_REDRAWLN,        /* y, lines */
+    PDC_EV_MOVE_HINT,       /* y, toy, lines */
+    PDC_EV_SELECTION,       /* start, end */
+    PDC_EV_WGETCH,          /* ms to wait, or -1 */
+    PDC_EV_UNGETCH,         /* key */
+    PDC_EV_FLUSHINP,
+    PDC_EV_PASTE_MODE,      /* on */
+    PDC_EV_INPUT,           /* platform event type, key code; on DOS
+                               and OS/2, scan code, character */
+    PDC_EV_COUNT
+};
+
+#define PDC_TRACE(x) if (SP && SP->trace_on) PDC_trace x
+
+/* Rendering counters */
+
+#ifdef PDCSTATS
+# define PDC_COUNT(field, n) (SP->stats.field += (n))
+#else
+# define PDC_COUNT(field, n)
+#endif
+
+/* Compare-and-swap and a full memory barrier, for the few functions
+   that may be called from other threads. Without a known compiler,
+   they're plain operations, and only one thread may use curses. */
+
+#if defined(__GNUC__)
+# define PDC_CAS(p, o, n) __sync_bool_compare_and_swap(p, o, n)
+# define PDC_FENCE() __sync_synchronize()
+#elif defined(_MSC_VER)
+# include <intrin.h>
+# define PDC_CAS(p, o, n) (_InterlockedCompareExchange((volatile long *)(p), \
+                           (long)(n), (long)(o)) == (long)(o))
+# define PDC_FENCE() _InterlockedOr(&pdc_fence, 0)
+extern volatile long pdc_fence;
+#else
+# define PDC_CAS(p, o, n) (*(p) == (o) ? (*(p) = (n), TRUE) : FALSE)
+# define PDC_FENCE()
+#endif
+
 /* Internal macros for attributes */
 
 #ifndef max
@@ -120,9 +191,38 @@ size_t  PDC_wcstombs(char *, const wchar_t *, size_t);
 
 #define PDC_CLICK_PERIOD 150  /* time to wait for a click, if
                                  not set by mouseinterval() */
-#define PDC_COLOR_PAIRS  256
+#define PDC_COLOR_PAIRS  256  /* pairs that fit in a chtype */
+#define PDC_EXT_PAIRS    32767  /* pairs reachable through opts */
 #define PDC_MAXCOL       768  /* maximum possible COLORS; may be less */
 
+#define PDC_IS_RGB(c)    ((c) >= PDC_COLOR_DIRECT)
+#define PDC_RED(c)       (((c) >> 16) & 0xff)
+#define PDC_GREEN(c)     (((c) >> 8) & 0xff)
+#define PDC_BLUE(c)      ((c) & 0xff)
+
+/* Side planes. PDC_SIDE_AT() is the side cell at (y, x) of a window, or
+   NULL if it has no plane; PDC_CELL_PAIR() is the pair that a cell is
+   drawn in, given its side cell, which may be NULL. */
+
+#define PDC_SIDE_AT(win, y, x) ((win)->_side ? (win)->_side[y] + (x) : \
+                                (PDC_SIDE *)NULL)
+
+#define PDC_CELL_PAIR(ch, side) (!((ch) & A_COLOR) && (side) ? \
+                                 (side)->pair : (int)PAIR_NUMBER(ch))
+
+#define PDC_SIDE_SAME(p, q) ((p).pair == (q).pair && (p).f == (q).f && \
+                             (p).b == (q).b)
+
+/* TRUE if a side cell has direct colors */
+
+#define PDC_SIDE_RGB(side) ((side) && ((side)->f || (side)->b))
+
+/* TRUE if cell (y, x) of a window with a side plane differs from the
+   side cell that a character written now would get */
+
+#define PDC_SIDE_DIFF(win, y, x) ((win)->_side && \
+    !PDC_SIDE_SAME((win)->_side[y][x], (win)->_sideattr))
+
 #define _INBUFSIZ        512  /* size of terminal input buffer */
 #define NUNGETCH         256  /* max # chars to ungetch() */
 
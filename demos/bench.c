@@ -0,0 +1,603 @@
+/*
+ * bench -- time the hot paths of a curses library: adding characters
+ * and strings, refreshing (with no, some, or all cells changed),
+ * scrolling, panels, overlay() and copywin(), at several screen sizes
+ * up to 500x200; plus alloc_pair(), and, with PDCurses, the batch
+ * writers waddcells() and waddchrect(), and the platform's
+ * PDC_transform_line(). It reports nanoseconds per operation, and for
+ * full updates, frames per second.
+ *
+ * Each test repeats until it has run for the given time (default 200
+ * ms). Sizes larger than the screen are used only if resize_term() can
+ * make it that big -- with PDCurses, the headless port can; with X11,
+ * give the size via "-lines" and "-cols", e.g. under Xvfb:
+ *
+ *     xvfb-run ./pdcbench -lines 200 -cols 500
+ *
+ * The results are printed after endwin().
+ *
+ * Usage: pdcbench [-t ms]
+ */
+
+#include <curses.h>
+#include <panel.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+# include <time.h>
+#else
+# include <sys/time.h>
+#endif
+
+#ifdef PDCURSES
+/* internal, but linked in; it's what each platform brings to a frame */
+void PDC_transform_line(int, int, int, const chtype *);
+#endif
+
+#define MAXRESULTS 200
+
+static const int sizes[][2] =
+{
+    {25, 80}, {50, 132}, {60, 200}, {200, 500}
+};
+
+static char results[MAXRESULTS][80];
+static int nresults = 0;
+
+static double budget = 200000.0;  /* microseconds per test */
+
+static WINDOW *win, *alt;         /* the test area, and its double */
+static int wl, wc;                /* their size */
+static unsigned long seed = 1;
+
+static double now_us(void)
+{
+#ifdef _WIN32
+    return clock() * (1000000.0 / CLOCKS_PER_SEC);
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec * 1000000.0 + tv.tv_usec;
+#endif
+}
+
+/* a fixed sequence, so every run does the same work */
+
+static int rnd(int n)
+{
+    seed = seed * 1103515245UL + 12345UL;
+
+    return (int)((seed >> 16) % (unsigned long)n);
+}
+
+static void note(const char *text)
+{
+    if (nresults < MAXRESULTS)
+        sprintf(results[nresults++], "%.79s", text);
+}
+
+/* Run fn, which does its work iter times and returns the number of
+   operations done, with iter doubling until it takes long enough; then
+   report the time per operation. Frame tests also get a rate. */
+
+static void run(const char *name, long (*fn)(long), bool frames)
+{
+    long iter = 1, ops;
+    double start, used;
+    char *out;
+
+    for (;;)
+    {
+        start = now_us();
+        ops = fn(iter);
+        used = now_us() - start;
+
+        if (used >= budget || iter >= 0x10000000L)
+            break;
+
+        iter = (used < budget / 16) ? iter * 16 : iter * 2;
+    }
+
+    if (ops < 1)
+        ops = 1;
+
+    if (used < 1)
+        used = 1;
+
+    if (nresults == MAXRESULTS)
+        return;
+
+    out = results[nresults++];
+
+    sprintf(out, "  %-26.26s %12.1f ns/op", name, used * 1000.0 / ops);
+
+    if (frames)
+        sprintf(out + strlen(out), " %9.1f fps", ops * 1000000.0 / used);
+}
+
+static void fill(WINDOW *w, int first)
+{
+    int y, x;
+
+    for (y = 0; y < wl; y++)
+    {
+        wmove(w, y, 0);
+
+        for (x = 0; x < wc; x++)
+            waddch(w, ((first + x + y) % 94 + '!') |
+                      COLOR_PAIR((x >> 3) % 8 + 1));
+    }
+}
+
+/* the tests: each returns the operations it did */
+
+static long t_waddch(long iter)
+{
+    long i;
+
+    for (i = 0; i < iter; i++)
+        fill(win, (int)i);
+
+    return iter * wl * wc;
+}
+
+static long t_waddstr(long iter)
+{
+    static char line[512];
+    long i;
+    int y, x;
+
+    for (x = 0; x < wc; x++)
+        line[x] = (char)(x % 94 + '!');
+    line[wc] = '\0';
+
+    for (i = 0; i < iter; i++)
+        for (y = 0; y < wl; y++)
+            mvwaddnstr(win, y, 0, line + (y + i) % 2, wc - 1);
+
+    return iter * wl * (wc - 1);
+}
+
+#ifdef PDC_WIDE
+static long t_wadd_wch(long iter)
+{
+    long i;
+    int y, x;
+
+    for (i = 0; i < iter; i++)
+        for (y = 0; y < wl; y++)
+        {
+            wmove(win, y, 0);
+
+            for (x = 0; x < wc; x++)
+            {
+                cchar_t cc;
+                wchar_t wch[2];
+
+                wch[0] = (wchar_t)(0x3b1 + (x + y + i) % 25);
+                wch[1] = 0;
+
+                setcchar(&cc, wch, A_NORMAL, 0, NULL);
+                wadd_wch(win, &cc);
+            }
+        }
+
+    return iter * wl * wc;
+}
+
+static long t_waddwstr(long iter)
+{
+    static wchar_t line[512];
+    long i;
+    int y, x;
+
+    for (x = 0; x < wc; x++)
+        line[x] = (wchar_t)(0x430 + x % 32);
+    line[wc] = 0;
+
+    for (i = 0; i < iter; i++)
+        for (y = 0; y < wl; y++)
+            mvwaddnwstr(win, y, 0, line + (y + i) % 2, wc - 1);
+
+    return iter * wl * (wc - 1);
+}
+#endif
+
+#ifdef PDCURSES
+/* the batch writers, storing the whole window in one call; from two
+   sets of cells, so that each call changes every cell */
+
+static PDC_CELL *cells = NULL;
+static chtype *rect = NULL;
+
+/* set up both: cells as two runs of wl * wc, and rect as rows of
+   wc + 1, read from an offset of 0 or 1 */
+
+static bool batch_setup(void)
+{
+    long i, n = (long)wl * wc;
+    int y, x;
+
+    if (!cells)
+        cells = malloc(2L * sizes[3][0] * sizes[3][1] * sizeof(PDC_CELL));
+
+    if (!rect)
+        rect = malloc((long)sizes[3][0] * (sizes[3][1] + 1) *
+                      sizeof(chtype));
+
+    if (!cells || !rect)
+        return FALSE;
+
+    for (i = 0; i < 2 * n; i++)
+    {
+        y = (int)(i % n / wc);
+        x = (int)(i % n % wc);
+
+        cells[i].y = y;
+        cells[i].x = x;
+        cells[i].ch = ((x + y + (i >= n)) % 94 + '!') |
+                      COLOR_PAIR((x >> 3) % 8 + 1);
+    }
+
+    for (y = 0; y < wl; y++)
+        for (x = 0; x <= wc; x++)
+            rect[(long)y * (wc + 1) + x] = ((x + y) % 94 + '!') |
+                                           COLOR_PAIR((x >> 3) % 8 + 1);
+
+    return TRUE;
+}
+
+static long t_waddcells(long iter)
+{
+    long i, n = (long)wl * wc;
+
+    for (i = 0; i < iter; i++)
+        waddcells(win, cells + (i & 1) * n, (int)n);
+
+    return iter;
+}
+
+static long t_waddchrect(long iter)
+{
+    long i;
+
+    for (i = 0; i < iter; i++)
+        waddchrect(win, 0, 0, wl, wc, rect + (i & 1), wc + 1);
+
+    return iter;
+}
+#endif
+
+/* everything touched, nothing changed: the cost of the diff alone */
+
+static long t_refresh_same(long iter)
+{
+    long i;
+
+    for (i = 0; i < iter; i++)
+    {
+        touchwin(win);
+        wrefresh(win);
+    }
+
+    return iter;
+}
+
+/* alternate two different screens: every cell changes */
+
+static long t_refresh_full(long iter)
+{
+    long i;
+
+    for (i = 0; i < iter; i++)
+    {
+        WINDOW *w = (i & 1) ? alt : win;
+
+        touchwin(w);
+        wrefresh(w);
+    }
+
+    return iter;
+}
+
+/* change 1% of the cells per frame */
+
+static long t_refresh_sparse(long iter)
+{
+    long i, j, n = wl * wc / 100;
+
+    for (i = 0; i < iter; i++)
+    {
+        for (j = 0; j < n; j++)
+            mvwaddch(win, rnd(wl), rnd(wc), 'a' + rnd(26));
+
+        wrefresh(win);
+    }
+
+    return iter;
+}
+
+static long t_wscrl(long iter)
+{
+    long i;
+
+    for (i = 0; i < iter; i++)
+    {
+        wscrl(win, 1);
+        mvwaddstr(win, wl - 1, 0, "scrolled in");
+    }
+
+    return iter;
+}
+
+static long t_wscrl_refresh(long iter)
+{
+    long i;
+
+    for (i = 0; i < iter; i++)
+    {
+        wscrl(win, 1);
+        mvwaddstr(win, wl - 1, 0, "scrolled in");
+        wrefresh(win);
+    }
+
+    return iter;
+}
+
+static PANEL **panels;
+static int npanels;
+
+/* hide one panel, show another, move a third, and update */
+
+static long t_panels(long iter)
+{
+    long i;
+
+    for (i = 0; i < iter; i++)
+    {
+        PANEL *p = panels[rnd(npanels)];
+
+        hide_panel(panels[rnd(npanels)]);
+        show_panel(panels[rnd(npanels)]);
+        move_panel(p, rnd(wl - 8), rnd(wc - 20));
+        top_panel(p);
+
+        update_panels();
+        doupdate();
+    }
+
+    return iter;
+}
+
+static long t_overlay(long iter)
+{
+    long i;
+
+    for (i = 0; i < iter; i++)
+        overlay(alt, win);
+
+    return iter;
+}
+
+static long t_copywin(long iter)
+{
+    long i;
+
+    for (i = 0; i < iter; i++)
+        copywin(alt, win, 0, 0, 0, 0, wl - 1, wc - 1, FALSE);
+
+    return iter;
+}
+
+#ifdef PDCURSES
+static chtype tline[512];
+
+/* one call per line of the window, so the time is per whole line */
+
+static long t_transform(long iter)
+{
+    long i;
+    int y;
+
+    for (i = 0; i < iter; i++)
+        for (y = 0; y < wl; y++)
+            PDC_transform_line(y, 0, wc, tline);
+
+    return iter * wl;
+}
+#endif
+
+/* alloc_pair() finding pairs it already has, and making new ones */
+
+static long t_pair_hit(long iter)
+{
+    long i;
+
+    for (i = 0; i < iter; i++)
+        alloc_pair((int)(i % 16), (int)(i / 16 % 16));
+
+    return iter;
+}
+
+static long t_pair_churn(long iter)
+{
+    long i;
+
+    for (i = 0; i < iter; i++)
+    {
+        int pair = alloc_pair(16 + rnd(COLORS - 16), 16 + rnd(COLORS - 16));
+
+        if (pair > 0 && !rnd(4))
+            free_pair(pair);
+    }
+
+    return iter;
+}
+
+/* set up the test area, growing the screen if needed and allowed */
+
+static bool setsize(int lines, int cols)
+{
+    if ((LINES < lines || COLS < cols) &&
+        (resize_term(lines, cols) == ERR || LINES < lines || COLS < cols))
+        return FALSE;
+
+    wl = lines;
+    wc = cols;
+
+    win = newwin(wl, wc, 0, 0);
+    alt = newwin(wl, wc, 0, 0);
+
+    if (!win || !alt)
+        return FALSE;
+
+    fill(alt, 1);
+
+    return TRUE;
+}
+
+static void endsize(void)
+{
+    delwin(win);
+    delwin(alt);
+
+    clearok(curscr, TRUE);
+}
+
+static void bench_size(void)
+{
+    int i, x;
+
+    run("waddch", t_waddch, FALSE);
+    run("waddstr", t_waddstr, FALSE);
+#ifdef PDC_WIDE
+    run("wadd_wch", t_wadd_wch, FALSE);
+    run("waddwstr", t_waddwstr, FALSE);
+#endif
+#ifdef PDCURSES
+    if (batch_setup())
+    {
+        run("waddcells, whole window", t_waddcells, FALSE);
+        run("waddchrect, whole window", t_waddchrect, FALSE);
+    }
+#endif
+    fill(win, 0);
+    wrefresh(win);
+
+    run("refresh, no change", t_refresh_same, TRUE);
+    run("refresh, 1% changed", t_refresh_sparse, TRUE);
+    run("refresh, all changed", t_refresh_full, TRUE);
+
+    scrollok(win, TRUE);
+    run("wscrl", t_wscrl, FALSE);
+    run("wscrl + refresh", t_wscrl_refresh, TRUE);
+
+    run("overlay, whole window", t_overlay, FALSE);
+    run("copywin, whole window", t_copywin, FALSE);
+
+    for (npanels = 10; npanels <= 100; npanels *= 10)
+    {
+        char name[32];
+
+        panels = malloc(npanels * sizeof(PANEL *));
+        if (!panels)
+            break;
+
+        for (i = 0; i < npanels; i++)
+        {
+            WINDOW *w = newwin(8, 20, rnd(wl - 8), rnd(wc - 20));
+
+            wbkgd(w, COLOR_PAIR(i % 8 + 1));
+            box(w, 0, 0);
+            mvwprintw(w, 1, 1, "panel %d", i);
+
+            panels[i] = new_panel(w);
+        }
+
+        sprintf(name, "panels (%d) + update", npanels);
+        run(name, t_panels, TRUE);
+
+        for (i = 0; i < npanels; i++)
+        {
+            WINDOW *w = panel_window(panels[i]);
+
+            del_panel(panels[i]);
+            delwin(w);
+        }
+
+        free(panels);
+    }
+
+#ifdef PDCURSES
+    for (x = 0; x < wc; x++)
+        tline[x] = (x % 94 + '!') | COLOR_PAIR(1);
+    run("PDC_transform_line, 1 line", t_transform, FALSE);
+
+    for (x = 0; x < wc; x++)
+        tline[x] = (x % 94 + '!') | COLOR_PAIR((x >> 3) % 8 + 1);
+    run("  (8-cell runs)", t_transform, FALSE);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    int i;
+
+    for (i = 1; i < argc - 1; i++)
+        if (!strcmp(argv[i], "-t"))
+            budget = atoi(argv[i + 1]) * 1000.0;
+
+    if (budget < 1000.0)
+        budget = 1000.0;
+
+#ifdef XCURSES
+    Xinitscr(argc, argv);
+#else
+    initscr();
+#endif
+    noecho();
+    curs_set(0);
+
+    start_color();
+    for (i = 1; i <= 8; i++)
+        init_pair((short)i, (short)(i % 8), (short)((i + 4) % 8));
+
+    note(longname());
+
+    if (COLORS > 16)
+    {
+        note("alloc_pair");
+        run("found", t_pair_hit, FALSE);
+        run("new, 1 in 4 freed", t_pair_churn, FALSE);
+    }
+
+    for (i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++)
+    {
+        char head[80];
+
+        sprintf(head, "%dx%d", sizes[i][1], sizes[i][0]);
+
+        if (!setsize(sizes[i][0], sizes[i][1]))
+        {
+            strcat(head, ": skipped, the screen can't be made that big");
+            note(head);
+            continue;
+        }
+
+        note(head);
+
+        bench_size();
+        endsize();
+    }
+
+    endwin();
+
+    for (i = 0; i < nresults; i++)
+        printf("%s\n", results[i]);
+
+    return 0;
+}
@@ -35,7 +35,7 @@ int main(int argc, char **argv)
     for (i = 0; i < 8; i++)
         init_pair(i, color_table[i], COLOR_BLACK);
 
-    seed = time((time_t *)0);
+    seed = getenv("PDC_REPLAY") ? 1 : time((time_t *)0);
     srand(seed);
     flag = 0;
 
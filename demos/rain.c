@@ -64,7 +64,7 @@ int main(int argc, char *argv[])
 #else
     initscr();
 #endif
-    seed = time((time_t *)0);
+    seed = getenv("PDC_REPLAY") ? 1 : time((time_t *)0);
     srand(seed);
 
     if (has_colors())
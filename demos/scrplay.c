@@ -0,0 +1,481 @@
+/*
+ * scrplay -- play back a screen recording, as written by
+ * PDC_record_screen(): through curses, at the recorded pace, or as
+ * fast as it can be drawn with -f; or as text, with -t, printing the
+ * time and the whole screen after each frame. With -n, it stops after
+ * that many frames, and with -t, prints only the last of them. The
+ * file may be "-", for standard input; so a compressed recording can be
+ * played with, e.g.:
+ *
+ *     zcat session.gz | ./scrplay -
+ *
+ * It must be built with the same chtype as the library that made the
+ * recording (i.e., wide or not). Cells in extended pairs, or in direct
+ * colors, are shown as such where the port supports them. In curses,
+ * "q" quits; at the end, any key does.
+ *
+ * Usage: scrplay [-f] [-t] [-n frames] file
+ */
+
+#include <curses.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static FILE *fp;
+static chtype *screen = NULL;   /* the recorded screen */
+static PDC_SIDE *sides = NULL;  /* its side cells */
+static bool *touched = NULL;    /* lines changed by the last frame */
+static int lines = 0, cols = 0;
+static bool text = FALSE;
+
+static int get_num(unsigned long *n)
+{
+    int ch, shift = 0;
+
+    *n = 0;
+
+    do
+    {
+        ch = getc(fp);
+        if (ch == EOF || shift >= (int)(sizeof(long) * 8))
+            return 0;
+
+        *n |= (unsigned long)(ch & 0x7f) << shift;
+        shift += 7;
+    } while (ch & 0x80);
+
+    return 1;
+}
+
+static int get_int(int *n)
+{
+    unsigned long u;
+
+    if (!get_num(&u))
+        return 0;
+
+    *n = (u & 1) ? (int)~(u >> 1) : (int)(u >> 1);
+
+    return 1;
+}
+
+/* resize the recorded screen, keeping what fits */
+
+static int set_size(int nlines, int ncols)
+{
+    chtype *newscr;
+    PDC_SIDE *newsides;
+    bool *newtouch;
+    long i;
+    int y, x;
+
+    if (nlines < 1 || ncols < 1 || nlines > 10000 || ncols > 10000)
+        return 0;
+
+    newscr = malloc((long)nlines * ncols * sizeof(chtype));
+    newsides = calloc((long)nlines * ncols, sizeof(PDC_SIDE));
+    newtouch = malloc(nlines * sizeof(bool));
+
+    if (!newscr || !newsides || !newtouch)
+        return 0;
+
+    for (y = 0; y < nlines; y++)
+    {
+        for (x = 0; x < ncols; x++)
+        {
+            i = (long)y * ncols + x;
+
+            if (y < lines && x < cols)
+            {
+                newscr[i] = screen[(long)y * cols + x];
+                newsides[i] = sides[(long)y * cols + x];
+            }
+            else
+                newscr[i] = ' ';
+        }
+
+        newtouch[y] = TRUE;
+    }
+
+    free(screen);
+    free(sides);
+    free(touched);
+
+    screen = newscr;
+    sides = newsides;
+    touched = newtouch;
+    lines = nlines;
+    cols = ncols;
+
+    if (!text)
+        resize_term(lines, cols);
+
+    return 1;
+}
+
+static void move_line(int y, int x, int ncols, int toy, int tox)
+{
+    memmove(screen + (long)toy * cols + tox, screen + (long)y * cols + x,
+            ncols * sizeof(chtype));
+    memmove(sides + (long)toy * cols + tox, sides + (long)y * cols + x,
+            ncols * sizeof(PDC_SIDE));
+}
+
+/* the block move of PDC_move_hint(), on the recorded screen */
+
+static int move_block(void)
+{
+    unsigned long n[6];
+    int i, y, x, nlines, ncols, toy, tox;
+
+    for (i = 0; i < 6; i++)
+        if (!get_num(n + i))
+            return 0;
+
+    y = (int)n[0];
+    x = (int)n[1];
+    nlines = (int)n[2];
+    ncols = (int)n[3];
+    toy = (int)n[4];
+    tox = (int)n[5];
+
+    if ((y > toy ? y : toy) + nlines > lines ||
+        (x > tox ? x : tox) + ncols > cols)
+        return 0;
+
+    if (toy > y)
+        for (i = nlines - 1; i >= 0; i--)
+            move_line(y + i, x, ncols, toy + i, tox);
+    else
+        for (i = 0; i < nlines; i++)
+            move_line(y + i, x, ncols, toy + i, tox);
+
+    for (i = toy; i < toy + nlines; i++)
+        touched[i] = TRUE;
+
+    return 1;
+}
+
+static int set_pairs(void)
+{
+    unsigned long count, pair;
+    int f, b;
+
+    if (!get_num(&count))
+        return 0;
+
+    while (count--)
+    {
+        if (!get_num(&pair) || !get_int(&f) || !get_int(&b))
+            return 0;
+
+        if (text || !has_colors())
+            continue;
+
+        if (!pair)
+            assume_default_colors(f, b);
+        else
+            init_extended_pair((int)pair, f, b);
+    }
+
+    return 1;
+}
+
+static int draw_runs(void)
+{
+    unsigned long count, dy, x, len, cell, i, n[3];
+    chtype *p, prev;
+    PDC_SIDE *sp, sprev;
+    bool sided;
+    long y = 0;
+
+    if (!get_num(&count))
+        return 0;
+
+    while (count--)
+    {
+        if (!get_num(&dy) || !get_num(&x) || !get_num(&len))
+            return 0;
+
+        y += (long)dy;
+        sided = len & 1;
+        len >>= 1;
+
+        if (y >= lines || x + len > (unsigned long)cols)
+            return 0;
+
+        p = screen + y * cols + x;
+        sp = sides + y * cols + x;
+        prev = 0;
+
+        for (i = 0; i < len; i++)
+        {
+            if (!get_num(&cell))
+                return 0;
+
+            prev ^= (chtype)cell;
+            *p++ = prev;
+        }
+
+        /* the side cells, or none */
+
+        sprev.pair = sprev.f = sprev.b = 0;
+
+        for (i = 0; i < len; i++)
+        {
+            if (sided)
+            {
+                if (!get_num(n) || !get_num(n + 1) || !get_num(n + 2))
+                    return 0;
+
+                sprev.pair ^= (int)n[0];
+                sprev.f ^= (int)n[1];
+                sprev.b ^= (int)n[2];
+            }
+
+            *sp++ = sprev;
+        }
+
+        touched[y] = TRUE;
+    }
+
+    return 1;
+}
+
+/* read and apply a frame; return 0 at the end, or on a bad frame */
+
+static int read_frame(unsigned long *delay)
+{
+    unsigned long flags, nlines, ncols;
+
+    if (!get_num(delay) || !get_num(&flags))
+        return 0;
+
+    if (flags & 1)
+        if (!get_num(&nlines) || !get_num(&ncols) ||
+            !set_size((int)nlines, (int)ncols))
+            return 0;
+
+    if ((flags & 2) && !move_block())
+        return 0;
+
+    if ((flags & 4) && !set_pairs())
+        return 0;
+
+    return draw_runs();
+}
+
+static void print_screen(long frame, unsigned long us)
+{
+    int y, x, end;
+
+    printf("frame %ld, %lu.%03lu s\n", frame, us / 1000000,
+           us / 1000 % 1000);
+
+    for (y = 0; y < lines; y++)
+    {
+        chtype *line = screen + (long)y * cols;
+
+        for (end = cols; end > 0 && (line[end - 1] & A_CHARTEXT) == ' ';)
+            end--;
+
+        for (x = 0; x < end; x++)
+        {
+            chtype ch = line[x];
+
+            /* line-drawing characters as ASCII; others as blanks */
+
+            if (ch & A_ALTCHARSET)
+            {
+                ch &= A_CHARTEXT;
+                ch = (ch && strchr("qs", (int)ch)) ? '-' :
+                     (ch == 'x') ? '|' :
+                     (ch && strchr("jklmntuvw", (int)ch)) ? '+' : ' ';
+            }
+
+            ch &= A_CHARTEXT;
+
+            if (ch < ' ' || ch == 0x7f)
+                ch = ' ';
+#ifdef PDC_WIDE
+            if (ch < 0x80)
+                putchar((int)ch);
+            else if (ch < 0x800)
+            {
+                putchar((int)(0xc0 | (ch >> 6)));
+                putchar((int)(0x80 | (ch & 0x3f)));
+            }
+            else
+            {
+                putchar((int)(0xe0 | (ch >> 12)));
+                putchar((int)(0x80 | ((ch >> 6) & 0x3f)));
+                putchar((int)(0x80 | (ch & 0x3f)));
+            }
+#else
+            putchar((int)ch);
+#endif
+        }
+
+        putchar('\n');
+    }
+}
+
+/* copy the changed lines to the real screen, and wait out the frame */
+
+static bool same_side(const PDC_SIDE *p, const PDC_SIDE *q)
+{
+    return p->pair == q->pair && p->f == q->f && p->b == q->b;
+}
+
+/* draw a line in runs of cells with the same side cell, each with the
+   window's pair and direct colors set to match */
+
+static void show_line(int y)
+{
+    chtype *line = screen + (long)y * cols;
+    PDC_SIDE *side = sides + (long)y * cols;
+    int x, len, pair;
+
+    for (x = 0; x < cols; x += len)
+    {
+        for (len = 1; x + len < cols && same_side(side + x, side + x + len);)
+            len++;
+
+        pair = side[x].pair;
+        wattr_set(stdscr, A_NORMAL, 0, &pair);
+        wrgb_set(stdscr, side[x].f ? side[x].f : -1,
+                 side[x].b ? side[x].b : -1);
+
+        mvaddchnstr(y, x, line + x, len);
+    }
+
+    pair = 0;
+    wattr_set(stdscr, A_NORMAL, 0, &pair);
+    wrgb_set(stdscr, -1, -1);
+}
+
+static bool show_frame(unsigned long *owed, bool fast)
+{
+    int y;
+
+    for (y = 0; y < lines && y < LINES; y++)
+        if (touched[y])
+        {
+            show_line(y);
+            touched[y] = FALSE;
+        }
+
+    refresh();
+
+    if (fast)
+        timeout(0);
+    else
+    {
+        timeout((int)(*owed / 1000));
+        *owed %= 1000;
+    }
+
+    return getch() != 'q';
+}
+
+int main(int argc, char **argv)
+{
+    char magic[8];
+    unsigned long size, nlines, ncols, delay, owed = 0, us = 0;
+    long frame = 0, last = -1;
+    bool fast = FALSE, quit = FALSE;
+    int i;
+
+    for (i = 1; i < argc - 1 && argv[i][0] == '-' && argv[i][1]; i++)
+        if (!strcmp(argv[i], "-f"))
+            fast = TRUE;
+        else if (!strcmp(argv[i], "-t"))
+            text = TRUE;
+        else if (!strcmp(argv[i], "-n") && i < argc - 2)
+            last = atol(argv[++i]);
+
+    if (i != argc - 1)
+    {
+        fprintf(stderr, "Usage: %s [-f] [-t] [-n frames] file\n", argv[0]);
+        return 1;
+    }
+
+    fp = strcmp(argv[i], "-") ? fopen(argv[i], "rb") : stdin;
+    if (!fp)
+    {
+        perror(argv[i]);
+        return 1;
+    }
+
+    if (fread(magic, 1, 8, fp) != 8 || memcmp(magic, "PDCSCRN1", 8) ||
+        !get_num(&size) || !get_num(&nlines) || !get_num(&ncols))
+    {
+        fprintf(stderr, "%s: not a PDCurses screen recording\n", argv[i]);
+        return 1;
+    }
+
+    if (size != sizeof(chtype))
+    {
+        fprintf(stderr, "%s: recorded with a %lu-byte chtype; this is "
+                "built for %d\n", argv[i], size, (int)sizeof(chtype));
+        return 1;
+    }
+
+    if (!text)
+    {
+#ifdef XCURSES
+        Xinitscr(argc, argv);
+#else
+        initscr();
+#endif
+        noecho();
+        curs_set(0);
+
+        if (has_colors())
+            start_color();
+    }
+
+    if (!set_size((int)nlines, (int)ncols))
+    {
+        if (!text)
+            endwin();
+
+        fprintf(stderr, "%s: bad screen size\n", argv[i]);
+        return 1;
+    }
+
+    while (frame != last && read_frame(&delay))
+    {
+        frame++;
+        us += delay;
+        owed += delay;
+
+        if (!text)
+        {
+            if (!show_frame(&owed, fast))
+            {
+                quit = TRUE;
+                break;
+            }
+        }
+        else if (last < 0)
+            print_screen(frame, us);
+    }
+
+    if (text && last >= 0 && frame)
+        print_screen(frame, us);
+
+    if (!text)
+    {
+        if (!quit)
+        {
+            timeout(-1);
+            getch();
+        }
+
+        endwin();
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * tracedump -- print a binary trace, as written by PDC_trace_dump(),
+ * as text: a line giving the clock the trace was stamped with, then
+ * one line per record, with its number, the time in ticks of that
+ * clock (microseconds, from PDC_us_count()) since the first record and
+ * since the one before, and the event with its values. It needs no
+ * curses library; but it must be built for the same kind of machine
+ * that wrote the trace.
+ *
+ * Usage: tracedump file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAXNAME 256
+
+typedef struct
+{
+    unsigned long seq, stamp;
+    long event, a, b, c;
+} TRACE_REC;
+
+static char **names;
+static unsigned long nnames;
+
+static int read_names(FILE *fp)
+{
+    char buf[MAXNAME];
+    unsigned long i;
+    int ch, len;
+
+    names = calloc(nnames, sizeof(char *));
+    if (!names)
+        return 0;
+
+    for (i = 0; i < nnames; i++)
+    {
+        len = 0;
+
+        while ((ch = getc(fp)) != EOF && ch)
+            if (len < MAXNAME - 1)
+                buf[len++] = (char)ch;
+
+        if (ch == EOF)
+            return 0;
+
+        buf[len] = 0;
+
+        names[i] = malloc(len + 1);
+        if (!names[i])
+            return 0;
+
+        strcpy(names[i], buf);
+    }
+
+    return 1;
+}
+
+/* print the event's name, then its values, labeled with the rest of
+   the words in its name entry */
+
+static void print_event(const TRACE_REC *rec)
+{
+    const char *p, *q;
+    long val[3];
+    int i;
+
+    if (rec->event < 0 || (unsigned long)rec->event >= nnames)
+    {
+        printf("event%ld %ld %ld %ld\n", rec->event, rec->a, rec->b,
+               rec->c);
+        return;
+    }
+
+    val[0] = rec->a;
+    val[1] = rec->b;
+    val[2] = rec->c;
+
+    p = names[rec->event];
+    q = strchr(p, ' ');
+
+    printf("%.*s", q ? (int)(q - p) : (int)strlen(p), p);
+
+    for (i = 0; q && i < 3; i++)
+    {
+        p = q + 1;
+        q = strchr(p, ' ');
+
+        printf(" %.*s=%ld", q ? (int)(q - p) : (int)strlen(p), p, val[i]);
+    }
+
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    char magic[8];
+    unsigned long hdr[4], first = 0, last = 0, count = 0;
+    TRACE_REC rec;
+    FILE *fp;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s file\n", argv[0]);
+        return 1;
+    }
+
+    fp = fopen(argv[1], "rb");
+    if (!fp)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    if (fread(magic, 1, 8, fp) != 8 || memcmp(magic, "PDCTRACE", 8) ||
+        fread(hdr, sizeof(unsigned long), 4, fp) != 4)
+    {
+        fprintf(stderr, "%s: not a PDCurses trace\n", argv[1]);
+        return 1;
+    }
+
+    if (hdr[0] != 0x01020304UL || hdr[1] != sizeof(long))
+    {
+        fprintf(stderr, "%s: written by a different kind of machine\n",
+                argv[1]);
+        return 1;
+    }
+
+    nnames = hdr[2];
+
+
+    if (!read_names(fp))
+    {
+        fprintf(stderr, "%s: bad event names\n", argv[1]);
+        return 1;
+    }
+
+    printf("clock: %lu ticks per second\n", hdr[3]);
+
+    while (fread(&rec, sizeof(rec), 1, fp) == 1)
+    {
+        if (!count++)
+            first = last = rec.stamp;
+
+        printf("%8lu %10lu %+9ld  ", rec.seq - 1, rec.stamp - first,
+               (long)(rec.stamp - last));
+        print_event(&rec);
+
+        last = rec.stamp;
+    }
+
+    fclose(fp);
+
+    return 0;
+}
@@ -18,15 +18,18 @@ void PDC_gotoyx(int row, int col)
     PDCINT(0x10, regs);
 }
 
-void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
+void _new_packet(attr_t attr, int pair, int lineno, int x, int len,
+                 const chtype *srcp)
 {
     attr_t sysattrs;
     int j;
     short fore, back;
     unsigned char mapped_attr;
 
+    PDC_COUNT(packets, 1);
+
     sysattrs = SP->termattrs;
-    pair_content(PAIR_NUMBER(attr), &fore, &back);
+    pair_content(pair, &fore, &back);
 
     if (attr & A_BOLD)
         fore |= 8;
@@ -126,28 +129,41 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
 
 void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
 {
+    const PDC_SIDE *side = PDC_SIDE_AT(curscr, lineno, x);
     attr_t old_attr, attr;
-    int i, j;
+    int i, j, old_pair, pair;
 
     PDC_LOG(("PDC_transform_line() - called: lineno=%d\n", lineno));
 
     old_attr = *srcp & (A_ATTRIBUTES ^ A_ALTCHARSET);
+    old_pair = PDC_CELL_PAIR(*srcp, side);
 
     for (i = 1, j = 1; j < len; i++, j++)
     {
         attr = srcp[i] & (A_ATTRIBUTES ^ A_ALTCHARSET);
+        pair = PDC_CELL_PAIR(srcp[i], side ? side + i : NULL);
 
-        if (attr != old_attr)
+        if (attr != old_attr || pair != old_pair)
         {
-            _new_packet(old_attr, lineno, x, i, srcp);
+            _new_packet(old_attr, old_pair, lineno, x, i, srcp);
             old_attr = attr;
+            old_pair = pair;
             srcp += i;
+            if (side)
+                side += i;
             x += i;
             i = 0;
         }
     }
 
-    _new_packet(old_attr, lineno, x, i, srcp);
+    _new_packet(old_attr, old_pair, lineno, x, i, srcp);
+}
+
+bool PDC_copy_area(int y, int x, int nlines, int ncols, int toy, int tox)
+{
+    PDC_LOG(("PDC_copy_area() - called: not supported\n"));
+
+    return FALSE;
 }
 
 void PDC_doupdate(void)
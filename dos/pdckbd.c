@@ -183,6 +183,33 @@ bool PDC_check_key(void)
     return !(regs.W.flags & 64);
 }
 
+/* PDC_wait_key() checks for posted keys as often as for input, so
+   there's nothing to wake */
+
+void PDC_wakeup(void)
+{
+}
+
+/* the BIOS clock ticks about every 55ms, so check every 50ms */
+
+bool PDC_wait_key(int *ms)
+{
+    PDC_LOG(("PDC_wait_key() - called: ms=%d\n", *ms));
+
+    while (!PDC_key_posted() && !PDC_check_key())
+    {
+        if (!*ms)
+            return FALSE;
+
+        PDC_napms(50);
+
+        if (*ms > 0)
+            *ms = max(*ms - 50, 0);
+    }
+
+    return TRUE;
+}
+
 static int _process_mouse_events(void)
 {
     int i;
@@ -331,6 +358,8 @@ int PDC_get_key(void)
     key = regs.h.al;
     scan = regs.h.ah;
 
+    PDC_TRACE((PDC_EV_INPUT, scan, key, 0));
+
     if (shift_status & 3)
         SP->key_modifiers |= PDC_KEY_MODIFIER_SHIFT;
 
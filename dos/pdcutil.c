@@ -13,6 +13,18 @@ void PDC_beep(void)
     PDCINT(0x10, regs);
 }
 
+/* the BIOS clock ticks 18.2 times a second, so this counts by 55 */
+
+unsigned long PDC_ms_count(void)
+{
+    return (unsigned long)getdosmemdword(0x46c) * 55;
+}
+
+unsigned long PDC_us_count(void)
+{
+    return PDC_ms_count() * 1000UL;
+}
+
 void PDC_napms(int ms)
 {
     PDCREGS regs;
@@ -0,0 +1,110 @@
+/* PDCurses */
+
+#include "pdchead.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*man-start**************************************************************
+
+clipboard
+---------
+
+### Synopsis
+
+    int PDC_getclipboard(char **contents, long *length);
+    int PDC_setclipboard(const char *contents, long length);
+    int PDC_freeclipboard(char *contents);
+    int PDC_clearclipboard(void);
+
+### Description
+
+   PDC_getclipboard() gets the textual contents of the system's
+   clipboard. This function returns the contents of the clipboard in the
+   contents argument. It is the responsibility of the caller to free the
+   memory returned, via PDC_freeclipboard(). The length of the clipboard
+   contents is returned in the length argument.
+
+   PDC_setclipboard() copies the supplied text into the system's
+   clipboard, emptying the clipboard prior to the copy.
+
+   PDC_clearclipboard() clears the internal clipboard.
+
+### Return Values
+
+    PDC_CLIP_SUCCESS        the call was successful
+    PDC_CLIP_MEMORY_ERROR   unable to allocate sufficient memory for
+                            the clipboard contents
+    PDC_CLIP_EMPTY          the clipboard contains no text
+    PDC_CLIP_ACCESS_ERROR   no clipboard support
+
+### Portability
+
+   Function              | X/Open | ncurses | NetBSD
+   :---------------------|:------:|:-------:|:------:
+   PDC_getclipboard      |    -   |    -    |   -
+   PDC_setclipboard      |    -   |    -    |   -
+   PDC_freeclipboard     |    -   |    -    |   -
+   PDC_clearclipboard    |    -   |    -    |   -
+
+**man-end****************************************************************/
+
+/* there's no system clipboard, so keep one here; NULL if none set */
+
+static char *pdc_clipboard = NULL;
+static long pdc_cliplen = 0;
+
+int PDC_getclipboard(char **contents, long *length)
+{
+    PDC_LOG(("PDC_getclipboard() - called\n"));
+
+    if (!pdc_clipboard)
+        return PDC_CLIP_EMPTY;
+
+    if ((*contents = malloc(pdc_cliplen + 1)) == NULL)
+        return PDC_CLIP_MEMORY_ERROR;
+
+    memcpy(*contents, pdc_clipboard, pdc_cliplen + 1);
+    *length = pdc_cliplen;
+
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_setclipboard(const char *contents, long length)
+{
+    PDC_LOG(("PDC_setclipboard() - called\n"));
+
+    PDC_clearclipboard();
+
+    if (contents)
+    {
+        if ((pdc_clipboard = malloc(length + 1)) == NULL)
+            return PDC_CLIP_MEMORY_ERROR;
+
+        memcpy(pdc_clipboard, contents, length);
+        pdc_clipboard[length] = '\0';
+        pdc_cliplen = length;
+    }
+
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_freeclipboard(char *contents)
+{
+    PDC_LOG(("PDC_freeclipboard() - called\n"));
+
+    free(contents);
+
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_clearclipboard(void)
+{
+    PDC_LOG(("PDC_clearclipboard() - called\n"));
+
+    free(pdc_clipboard);
+    pdc_clipboard = NULL;
+    pdc_cliplen = 0;
+
+    return PDC_CLIP_SUCCESS;
+}
@@ -0,0 +1,174 @@
+/* PDCurses */
+
+#include "pdchead.h"
+
+#include <string.h>
+
+#ifdef PDC_WIDE
+# include "../common/acsuni.h"
+#else
+# include "../common/acs437.h"
+#endif
+
+chtype *pdc_fb = NULL;
+PDC_SIDE *pdc_fb_side = NULL;
+int pdc_cursrow = 0, pdc_curscol = 0;
+unsigned long pdc_frames = 0;
+
+/* position "hardware" cursor at (y, x) */
+
+void PDC_gotoyx(int row, int col)
+{
+    PDC_LOG(("PDC_gotoyx() - called: row %d col %d\n", row, col));
+
+    pdc_cursrow = row;
+    pdc_curscol = col;
+}
+
+/* copy a run of cells with one attribute, pair and set of direct
+   colors into the framebuffer, mapping the alternate character set as
+   it goes */
+
+void _new_packet(attr_t attr, int pair, const PDC_SIDE *side, int lineno,
+                 int x, int len, const chtype *srcp)
+{
+    chtype *dest = pdc_fb + (long)lineno * pdc_cols + x;
+    PDC_SIDE *sdest = pdc_fb_side + (long)lineno * pdc_cols + x;
+    int j;
+
+    PDC_COUNT(packets, 1);
+
+    for (j = 0; j < len; j++)
+    {
+        chtype ch = srcp[j];
+
+        if (ch & A_ALTCHARSET && !(ch & 0xff80))
+            ch = acs_map[ch & 0x7f];
+
+        dest[j] = (ch & (A_CHARTEXT | A_ALTCHARSET)) | attr;
+
+        sdest[j].pair = pair;
+        sdest[j].f = side ? side->f : 0;
+        sdest[j].b = side ? side->b : 0;
+    }
+}
+
+/* update the given physical line to look like the corresponding line in
+   curscr */
+
+void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
+{
+    const PDC_SIDE *side = PDC_SIDE_AT(curscr, lineno, x);
+    attr_t old_attr, attr;
+    int i, j, old_pair, pair;
+
+    PDC_LOG(("PDC_transform_line() - called: lineno=%d\n", lineno));
+
+    old_attr = *srcp & (A_ATTRIBUTES ^ A_ALTCHARSET);
+    old_pair = PDC_CELL_PAIR(*srcp, side);
+
+    for (i = 1, j = 1; j < len; i++, j++)
+    {
+        attr = srcp[i] & (A_ATTRIBUTES ^ A_ALTCHARSET);
+        pair = PDC_CELL_PAIR(srcp[i], side ? side + i : NULL);
+
+        if (attr != old_attr || pair != old_pair || (side &&
+            (side[i].f != side->f || side[i].b != side->b)))
+        {
+            _new_packet(old_attr, old_pair, side, lineno, x, i, srcp);
+            old_attr = attr;
+            old_pair = pair;
+            srcp += i;
+            if (side)
+                side += i;
+            x += i;
+            i = 0;
+        }
+    }
+
+    _new_packet(old_attr, old_pair, side, lineno, x, i, srcp);
+}
+
+bool PDC_copy_area(int y, int x, int nlines, int ncols, int toy, int tox)
+{
+    long from = (long)y * pdc_cols + x, to = (long)toy * pdc_cols + tox;
+    long i;
+
+    PDC_LOG(("PDC_copy_area() - called: y %d x %d to %d %d\n",
+             y, x, toy, tox));
+
+    /* rows may overlap, so go from the far end when moving down */
+
+    if (toy > y)
+        for (i = (long)(nlines - 1) * pdc_cols; i >= 0; i -= pdc_cols)
+        {
+            memmove(pdc_fb + to + i, pdc_fb + from + i,
+                    ncols * sizeof(chtype));
+            memmove(pdc_fb_side + to + i, pdc_fb_side + from + i,
+                    ncols * sizeof(PDC_SIDE));
+        }
+    else
+        for (i = 0; i < (long)nlines * pdc_cols; i += pdc_cols)
+        {
+            memmove(pdc_fb + to + i, pdc_fb + from + i,
+                    ncols * sizeof(chtype));
+            memmove(pdc_fb_side + to + i, pdc_fb_side + from + i,
+                    ncols * sizeof(PDC_SIDE));
+        }
+
+    return TRUE;
+}
+
+void PDC_doupdate(void)
+{
+    pdc_frames++;
+}
+
+/* write the framebuffer's text to fp, one line per row, without the
+   attributes; in wide builds, as UTF-8 */
+
+void PDC_dump_screen(FILE *fp)
+{
+    int y, x;
+
+    if (!pdc_fb)
+        return;
+
+    for (y = 0; y < pdc_lines; y++)
+    {
+        for (x = 0; x < pdc_cols; x++)
+        {
+            chtype ch = pdc_fb[(long)y * pdc_cols + x];
+
+            /* unmapped ACS glyphs and control characters show as
+               blanks */
+
+            if (ch & A_ALTCHARSET)
+                ch = ' ';
+
+            ch &= A_CHARTEXT;
+
+            if (ch < ' ' || ch == 0x7f)
+                ch = ' ';
+#ifdef PDC_WIDE
+            if (ch < 0x80)
+                putc((int)ch, fp);
+            else if (ch < 0x800)
+            {
+                putc((int)(0xc0 | (ch >> 6)), fp);
+                putc((int)(0x80 | (ch & 0x3f)), fp);
+            }
+            else
+            {
+                putc((int)(0xe0 | (ch >> 12)), fp);
+                putc((int)(0x80 | ((ch >> 6) & 0x3f)), fp);
+                putc((int)(0x80 | (ch & 0x3f)), fp);
+            }
+#else
+            putc((int)ch, fp);
+#endif
+        }
+
+        putc('\n', fp);
+    }
+}
@@ -0,0 +1,18 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+PDCEX  chtype *pdc_fb;                /* the screen, pdc_lines rows of
+                                         pdc_cols cells, as drawn */
+PDCEX  PDC_SIDE *pdc_fb_side;         /* each cell's full pair number
+                                         and direct colors */
+PDCEX  int pdc_lines, pdc_cols;       /* its size */
+PDCEX  int pdc_cursrow, pdc_curscol;  /* where the cursor was last put */
+PDCEX  unsigned long pdc_frames;      /* PDC_doupdate() calls */
+
+PDCEX  int PDC_push_key(int key, unsigned long modifiers);
+PDCEX  int PDC_push_mouse(const MOUSE_STATUS *status);
+PDCEX  int PDC_push_resize(int nlines, int ncols);
+PDCEX  void PDC_dump_screen(FILE *fp);
+
+extern short pdc_color[PDC_MAXCOL][3];  /* RGB, 0-1000 */
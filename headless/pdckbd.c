@@ -0,0 +1,292 @@
+/* PDCurses */
+
+#include "pdchead.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* The input queue: keys, mouse events and resizes pushed by the
+   program, taken in order by PDC_get_key(). When it's empty, the next
+   byte of the file named by PDC_INPUT, if any, is queued as a key --
+   so a script is "typed" only as fast as the program reads it, and
+   flushinp() doesn't lose it. */
+
+#define QUEUE_SIZE 512
+
+typedef struct
+{
+    int key;                  /* KEY_MOUSE and KEY_RESIZE use the rest */
+    unsigned long modifiers;
+    MOUSE_STATUS mouse;
+    int lines, cols;
+} INPUT_EVENT;
+
+static INPUT_EVENT queue[QUEUE_SIZE];
+static int head = 0, tail = 0;
+static FILE *script = NULL;
+static bool script_tried = FALSE;
+
+static INPUT_EVENT *_push(int key)
+{
+    INPUT_EVENT *ev;
+
+    if ((head + 1) % QUEUE_SIZE == tail)
+        return NULL;
+
+    ev = queue + head;
+    memset(ev, 0, sizeof(INPUT_EVENT));
+    ev->key = key;
+
+    head = (head + 1) % QUEUE_SIZE;
+
+    return ev;
+}
+
+int PDC_push_key(int key, unsigned long modifiers)
+{
+    INPUT_EVENT *ev;
+
+    PDC_LOG(("PDC_push_key() - called: key %d\n", key));
+
+    if (key < 0 || key == KEY_MOUSE || key == KEY_RESIZE)
+        return ERR;
+
+    ev = _push(key);
+    if (!ev)
+        return ERR;
+
+    ev->modifiers = modifiers;
+
+    PDC_wakeup();
+
+    return OK;
+}
+
+int PDC_push_mouse(const MOUSE_STATUS *status)
+{
+    INPUT_EVENT *ev;
+
+    PDC_LOG(("PDC_push_mouse() - called\n"));
+
+    if (!status)
+        return ERR;
+
+    ev = _push(KEY_MOUSE);
+    if (!ev)
+        return ERR;
+
+    ev->mouse = *status;
+
+    PDC_wakeup();
+
+    return OK;
+}
+
+int PDC_push_resize(int nlines, int ncols)
+{
+    INPUT_EVENT *ev;
+
+    PDC_LOG(("PDC_push_resize() - called: %d x %d\n", nlines, ncols));
+
+    if (nlines < 2 || ncols < 2)
+        return ERR;
+
+    ev = _push(KEY_RESIZE);
+    if (!ev)
+        return ERR;
+
+    ev->lines = nlines;
+    ev->cols = ncols;
+
+    PDC_wakeup();
+
+    return OK;
+}
+
+void PDC_set_keyboard_binary(bool on)
+{
+    PDC_LOG(("PDC_set_keyboard_binary() - called\n"));
+}
+
+/* check if a key or mouse event is waiting */
+
+bool PDC_check_key(void)
+{
+    if (head == tail)
+    {
+        int ch = EOF;
+
+        if (!script_tried)
+        {
+            const char *name = getenv("PDC_INPUT");
+
+            if (name)
+                script = fopen(name, "rb");
+
+            script_tried = TRUE;
+        }
+
+        if (script && (ch = getc(script)) == EOF)
+        {
+            fclose(script);
+            script = NULL;
+        }
+
+        if (ch != EOF)
+            _push(ch);
+    }
+
+    return head != tail;
+}
+
+/* PDC_wakeup() writes to this pipe to end a poll() in PDC_wait_key(),
+   and so do the PDC_push_*() functions. It's made on the first wait,
+   and kept for the life of the process; events queued before then are
+   seen when the wait starts. */
+
+static int wake_pipe[2] = {-1, -1};
+
+static void _make_wake_pipe(void)
+{
+    int fds[2];
+
+    if (pipe(fds) == -1)
+        return;
+
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+
+    wake_pipe[0] = fds[0];
+    wake_pipe[1] = fds[1];
+}
+
+void PDC_wakeup(void)
+{
+    char c = 0;
+
+    if (wake_pipe[1] == -1)
+        return;
+
+    /* retry if a signal interrupts the write; if the pipe is full
+       (EAGAIN), a wakeup is pending anyway */
+
+    while (write(wake_pipe[1], &c, 1) == -1 && errno == EINTR)
+        ;
+}
+
+/* Once the queue and script are empty, only PDC_post_key() or a push
+   can end the wait, so sleep on the wake pipe until one comes, or the
+   time runs out. Without another thread to post or push keys, a wait
+   without a timeout never ends. */
+
+bool PDC_wait_key(int *ms)
+{
+    unsigned long start;
+    int left = *ms;
+
+    PDC_LOG(("PDC_wait_key() - called: ms=%d\n", *ms));
+
+    if (wake_pipe[0] == -1)
+        _make_wake_pipe();
+
+    start = PDC_ms_count();
+
+    for (;;)
+    {
+        bool ready = PDC_key_posted() || PDC_check_key();
+
+        if (*ms >= 0)
+            left = max(*ms - (int)(PDC_ms_count() - start), 0);
+
+        if (ready)
+            break;
+
+        if (!left)
+            return FALSE;
+
+        if (wake_pipe[0] != -1)
+        {
+            struct pollfd fd;
+            char buf[64];
+
+            fd.fd = wake_pipe[0];
+            fd.events = POLLIN;
+
+            if (poll(&fd, 1, left) > 0 && (fd.revents & POLLIN))
+                while (read(wake_pipe[0], buf, sizeof(buf)) > 0)
+                    ;
+        }
+        else
+            PDC_napms((left < 0 || left > 10) ? 10 : left);
+    }
+
+    *ms = left;
+
+    return TRUE;
+}
+
+/* return the next available key or mouse event */
+
+int PDC_get_key(void)
+{
+    INPUT_EVENT *ev;
+
+    if (!PDC_check_key())
+        return -1;
+
+    ev = queue + tail;
+    tail = (tail + 1) % QUEUE_SIZE;
+
+    SP->key_modifiers = ev->modifiers;
+    SP->key_code = (ev->key >= KEY_MIN);
+
+    switch (ev->key)
+    {
+    case KEY_MOUSE:
+        SP->mouse_status = ev->mouse;
+        SP->mouse_count = 1;
+        break;
+    case KEY_RESIZE:
+        if (ev->lines == pdc_lines && ev->cols == pdc_cols)
+            return -1;
+
+        pdc_lines = ev->lines;
+        pdc_cols = ev->cols;
+
+        if (SP->resized)
+            return -1;
+
+        SP->resized = TRUE;
+    }
+
+    return ev->key;
+}
+
+/* discard any pending keyboard or mouse input -- this is the core
+   routine for flushinp() */
+
+void PDC_flushinp(void)
+{
+    PDC_LOG(("PDC_flushinp() - called\n"));
+
+    head = tail = 0;
+}
+
+bool PDC_has_mouse(void)
+{
+    return TRUE;
+}
+
+int PDC_mouse_set(void)
+{
+    return OK;
+}
+
+int PDC_modifiers_set(void)
+{
+    return OK;
+}
@@ -0,0 +1,192 @@
+/* PDCurses */
+
+#include "pdchead.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+int pdc_lines = 0, pdc_cols = 0;
+short pdc_color[PDC_MAXCOL][3];
+
+/* (re)allocate the framebuffer at the current size, blank */
+
+static int _alloc_fb(void)
+{
+    long i, cells = (long)pdc_lines * pdc_cols;
+    chtype *fb = realloc(pdc_fb, cells * sizeof(chtype));
+    PDC_SIDE *side;
+
+    if (!fb)
+        return ERR;
+
+    pdc_fb = fb;
+
+    side = realloc(pdc_fb_side, cells * sizeof(PDC_SIDE));
+    if (!side)
+        return ERR;
+
+    pdc_fb_side = side;
+
+    for (i = 0; i < cells; i++)
+        pdc_fb[i] = ' ';
+
+    memset(pdc_fb_side, 0, cells * sizeof(PDC_SIDE));
+
+    return OK;
+}
+
+/* write the final screen to the file named by PDC_DUMP, if set */
+
+void PDC_scr_close(void)
+{
+    const char *name = getenv("PDC_DUMP");
+
+    PDC_LOG(("PDC_scr_close() - called\n"));
+
+    if (name)
+    {
+        FILE *fp = fopen(name, "w");
+
+        if (fp)
+        {
+            PDC_dump_screen(fp);
+            fclose(fp);
+        }
+    }
+}
+
+void PDC_scr_free(void)
+{
+    free(pdc_fb);
+    pdc_fb = NULL;
+
+    free(pdc_fb_side);
+    pdc_fb_side = NULL;
+}
+
+static void _initialize_colors(void)
+{
+    int i, r, g, b;
+
+    for (i = 0; i < 8; i++)
+    {
+        pdc_color[i][0] = (i & COLOR_RED) ? 753 : 0;
+        pdc_color[i][1] = (i & COLOR_GREEN) ? 753 : 0;
+        pdc_color[i][2] = (i & COLOR_BLUE) ? 753 : 0;
+
+        pdc_color[i + 8][0] = (i & COLOR_RED) ? 1000 : 251;
+        pdc_color[i + 8][1] = (i & COLOR_GREEN) ? 1000 : 251;
+        pdc_color[i + 8][2] = (i & COLOR_BLUE) ? 1000 : 251;
+    }
+
+    /* 256-color xterm extended palette: 216 colors in a 6x6x6 color
+       cube, plus 24 shades of gray */
+
+    for (i = 16, r = 0; r < 6; r++)
+        for (g = 0; g < 6; g++)
+            for (b = 0; b < 6; b++, i++)
+            {
+                pdc_color[i][0] = DIVROUND((r ? r * 40 + 55 : 0) * 1000, 255);
+                pdc_color[i][1] = DIVROUND((g ? g * 40 + 55 : 0) * 1000, 255);
+                pdc_color[i][2] = DIVROUND((b ? b * 40 + 55 : 0) * 1000, 255);
+            }
+
+    for (i = 232; i < 256; i++)
+        pdc_color[i][0] = pdc_color[i][1] = pdc_color[i][2] =
+            DIVROUND(((i - 232) * 10 + 8) * 1000, 255);
+}
+
+/* open the physical screen -- miscellaneous initialization; the size
+   comes from PDC_LINES and PDC_COLS, or defaults to 80x25 */
+
+int PDC_scr_open(void)
+{
+    const char *env;
+
+    PDC_LOG(("PDC_scr_open() - called\n"));
+
+    env = getenv("PDC_LINES");
+    pdc_lines = env ? atoi(env) : 25;
+
+    env = getenv("PDC_COLS");
+    pdc_cols = env ? atoi(env) : 80;
+
+    if (pdc_lines < 2 || pdc_cols < 2 || _alloc_fb() == ERR)
+    {
+        fprintf(stderr, "Couldn't create a %dx%d screen\n",
+                pdc_cols, pdc_lines);
+        return ERR;
+    }
+
+    _initialize_colors();
+
+    SP->mono = FALSE;
+    SP->orig_attr = FALSE;
+    SP->mouse_wait = PDC_CLICK_PERIOD;
+    SP->audible = FALSE;
+
+    SP->termattrs = A_COLOR | A_UNDERLINE | A_LEFT | A_RIGHT | A_REVERSE |
+                    A_ITALIC;
+    SP->rgb_color = TRUE;
+
+    PDC_reset_prog_mode();
+
+    return OK;
+}
+
+/* the core of resize_term() */
+
+int PDC_resize_screen(int nlines, int ncols)
+{
+    if (nlines && ncols)
+    {
+        if (nlines < 2 || ncols < 2)
+            return ERR;
+
+        pdc_lines = nlines;
+        pdc_cols = ncols;
+    }
+
+    return _alloc_fb();
+}
+
+void PDC_reset_prog_mode(void)
+{
+    PDC_LOG(("PDC_reset_prog_mode() - called.\n"));
+}
+
+void PDC_reset_shell_mode(void)
+{
+    PDC_LOG(("PDC_reset_shell_mode() - called.\n"));
+}
+
+void PDC_restore_screen_mode(int i)
+{
+}
+
+void PDC_save_screen_mode(int i)
+{
+}
+
+bool PDC_can_change_color(void)
+{
+    return TRUE;
+}
+
+int PDC_color_content(short color, short *red, short *green, short *blue)
+{
+    *red = pdc_color[color][0];
+    *green = pdc_color[color][1];
+    *blue = pdc_color[color][2];
+
+    return OK;
+}
+
+int PDC_init_color(short color, short red, short green, short blue)
+{
+    pdc_color[color][0] = red;
+    pdc_color[color][1] = green;
+    pdc_color[color][2] = blue;
+
+    return OK;
+}
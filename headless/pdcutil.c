@@ -0,0 +1,48 @@
+/* PDCurses */
+
+#include "pdchead.h"
+
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+void PDC_beep(void)
+{
+    PDC_LOG(("PDC_beep() - called\n"));
+}
+
+unsigned long PDC_ms_count(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec * 1000UL + tv.tv_usec / 1000;
+}
+
+unsigned long PDC_us_count(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec * 1000000UL + tv.tv_usec;
+}
+
+void PDC_napms(int ms)
+{
+    struct timeval tv;
+
+    PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
+
+    tv.tv_sec = ms / 1000;
+    tv.tv_usec = (ms % 1000) * 1000;
+
+    select(0, NULL, NULL, NULL, &tv);
+}
+
+const char *PDC_sysname(void)
+{
+    return "headless";
+}
@@ -132,6 +132,44 @@ bool PDC_check_key(void)
     return (keyInfo.fbStatus != 0);
 }
 
+/* PDC_wait_key() checks for posted keys as often as for input, so
+   there's nothing to wake */
+
+void PDC_wakeup(void)
+{
+}
+
+/* there's no waiting on both the keyboard and the mouse with a timeout,
+   so check every 10ms */
+
+bool PDC_wait_key(int *ms)
+{
+    ULONG start = PDC_ms_count();
+    int left = *ms;
+
+    PDC_LOG(("PDC_wait_key() - called: ms=%d\n", *ms));
+
+    for (;;)
+    {
+        bool ready = PDC_key_posted() || PDC_check_key();
+
+        if (*ms >= 0)
+            left = max(*ms - (int)(PDC_ms_count() - start), 0);
+
+        if (ready)
+            break;
+
+        if (!left)
+            return FALSE;
+
+        PDC_napms((left < 0 || left > 10) ? 10 : left);
+    }
+
+    *ms = left;
+
+    return TRUE;
+}
+
 static int _process_mouse_events(void)
 {
     MOUEVENTINFO event;
@@ -302,6 +340,8 @@ int PDC_get_key(void)
     key = keyInfo.chChar;
     scan = keyInfo.chScan;
 
+    PDC_TRACE((PDC_EV_INPUT, scan, key, 0));
+
     if (keyInfo.fsState & KBDSTF_ALT)
         SP->key_modifiers |= PDC_KEY_MODIFIER_ALT;
 
@@ -18,7 +18,6 @@ extern short pdc_curstoreal[16];
 extern int pdc_font;
 extern bool pdc_is_windowed;
 
-extern ULONG PDC_ms_count(void);
 extern void PDC_get_keyboard_info(void);
 extern void PDC_set_keyboard_default(void);
 extern void PDC_blink_text(void);
@@ -13,7 +13,7 @@ void PDC_beep(void)
     DosBeep(1380, 100);
 }
 
-ULONG PDC_ms_count(void)
+unsigned long PDC_ms_count(void)
 {
     ULONG now;
 
@@ -22,6 +22,11 @@ ULONG PDC_ms_count(void)
     return now;
 }
 
+unsigned long PDC_us_count(void)
+{
+    return PDC_ms_count() * 1000UL;
+}
+
 void PDC_napms(int ms)
 {
     PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
@@ -29,6 +29,8 @@ typedef struct panel
     struct panel *above;
     const void *user;
     struct panelobs *obscure;
+    long zorder;
+    bool linked;
 } PANEL;
 
 PDCEX  int     bottom_panel(PANEL *pan);
@@ -38,6 +40,7 @@ PDCEX  int     move_panel(PANEL *pan, int starty, int startx);
 PDCEX  PANEL  *new_panel(WINDOW *win);
 PDCEX  PANEL  *panel_above(const PANEL *pan);
 PDCEX  PANEL  *panel_below(const PANEL *pan);
+PDCEX  int     panel_move_above(PANEL *pan, PANEL *ref);
 PDCEX  int     panel_hidden(const PANEL *pan);
 PDCEX  const void *panel_userptr(const PANEL *pan);
 PDCEX  WINDOW *panel_window(const PANEL *pan);
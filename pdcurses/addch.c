@@ -242,9 +242,10 @@ int waddch(WINDOW *win, const chtype ch)
         /* wrs (4/10/93): Apply the same sort of logic for the window
            background, in that it only takes precedence if other color
            attributes are not there and that the background character
-           will only print if the printing character is blank. */
+           will only print if the printing character is blank. A window
+           set to an extended pair has a color, though not in A_COLOR. */
 
-        if (!(attr & A_COLOR))
+        if (!(attr & A_COLOR) && !win->_sideattr.pair)
             attr |= win->_bkgd & A_ATTRIBUTES;
         else
             attr |= win->_bkgd & (A_ATTRIBUTES ^ A_COLOR);
@@ -260,7 +261,7 @@ int waddch(WINDOW *win, const chtype ch)
            different from the character/attribute that is already in
            that position in the window. */
 
-        if (win->_y[y][x] != text)
+        if (win->_y[y][x] != text || PDC_SIDE_DIFF(win, y, x))
         {
             if (win->_firstch[y] == _NO_CHANGE)
                 win->_firstch[y] = win->_lastch[y] = x;
@@ -272,6 +273,9 @@ int waddch(WINDOW *win, const chtype ch)
                         win->_lastch[y] = x;
 
             win->_y[y][x] = text;
+
+            if (win->_side)
+                win->_side[y][x] = win->_sideattr;
         }
 
 #ifdef PDC_WIDE
@@ -281,7 +285,8 @@ int waddch(WINDOW *win, const chtype ch)
             if (++x < win->_maxx)
             {
                 /* Place placeholder in second cell */
-                if (win->_y[y][x] != (PDC_WIDE_PLACEHOLDER | attr))
+                if (win->_y[y][x] != (PDC_WIDE_PLACEHOLDER | attr) ||
+                    PDC_SIDE_DIFF(win, y, x))
                 {
                     if (win->_firstch[y] == _NO_CHANGE)
                         win->_firstch[y] = win->_lastch[y] = x;
@@ -289,6 +294,9 @@ int waddch(WINDOW *win, const chtype ch)
                         win->_lastch[y] = x;
 
                     win->_y[y][x] = PDC_WIDE_PLACEHOLDER | attr;
+
+                    if (win->_side)
+                        win->_side[y][x] = win->_sideattr;
                 }
             }
             else
@@ -330,10 +338,7 @@ int waddch(WINDOW *win, const chtype ch)
     win->_curx = x;
     win->_cury = y;
 
-    if (win->_immed)
-        wrefresh(win);
-    if (win->_sync)
-        wsyncup(win);
+    PDC_sync(win);
 
     return OK;
 }
@@ -28,6 +28,10 @@ addchstr
     int mvwadd_wchnstr(WINDOW *win, int y, int x, const cchar_t *wch,
                        int n);
 
+    int waddcells(WINDOW *win, const PDC_CELL *cells, int n);
+    int waddchrect(WINDOW *win, int y, int x, int nlines, int ncols,
+                   const chtype *ch, int stride);
+
 ### Description
 
    These routines write a chtype or cchar_t string directly into the
@@ -40,6 +44,19 @@ addchstr
    newline or other special characters, nor does any line wrapping
    occur.
 
+   waddcells() and waddchrect() are PDCurses-specific batch writers for
+   grid-style output. waddcells() stores n cells, each given as a
+   PDC_CELL holding window coordinates y, x and a chtype ch.
+   waddchrect() stores an nlines by ncols rectangle with its upper
+   left corner at (y, x), read from ch in row-major order; stride is
+   the distance in chtypes between the starts of successive rows, or 0
+   for ncols. Each cell gets the same attribute and background merge as
+   with waddch(), but no control character translation. Every
+   coordinate is validated before anything is written, so on ERR the
+   window is unchanged. The cursor is not moved, and the window's
+   immedok() and syncok() updates are done once, after all cells are
+   stored.
+
 ### Return Value
 
    All functions return OK or ERR.
@@ -64,6 +81,8 @@ addchstr
    wadd_wchnstr          |    Y   |    Y    |   Y
    mvadd_wchnstr         |    Y   |    Y    |   Y
    mvwadd_wchnstr        |    Y   |    Y    |   Y
+   waddcells             |    -   |    -    |   -
+   waddchrect            |    -   |    -    |   -
 
 **man-end****************************************************************/
 
@@ -91,7 +110,7 @@ int waddchnstr(WINDOW *win, const chtype *ch, int n)
 
     for (; n && *ch; n--, x++, ptr++, ch++)
     {
-        if (*ptr != *ch)
+        if (*ptr != *ch || PDC_SIDE_DIFF(win, y, x))
         {
             if (x < minx || minx == _NO_CHANGE)
                 minx = x;
@@ -105,6 +124,9 @@ int waddchnstr(WINDOW *win, const chtype *ch, int n)
                      win->_firstch[y], win->_lastch[y]));
 
             *ptr = *ch;
+
+            if (win->_side)
+                win->_side[y][x] = win->_sideattr;
         }
     }
 
@@ -114,6 +136,136 @@ int waddchnstr(WINDOW *win, const chtype *ch, int n)
     return OK;
 }
 
+/* The attribute and background merge from waddch() */
+
+static chtype _merge(WINDOW *win, chtype ch)
+{
+    chtype text = ch & A_CHARTEXT;
+    chtype attr = ch & A_ATTRIBUTES;
+
+    if (!(attr & A_COLOR))
+        attr |= win->_attrs;
+
+    if (!(attr & A_COLOR) && !win->_sideattr.pair)
+        attr |= win->_bkgd & A_ATTRIBUTES;
+    else
+        attr |= win->_bkgd & (A_ATTRIBUTES ^ A_COLOR);
+
+    if (text == ' ')
+        text = win->_bkgd & A_CHARTEXT;
+
+    return text | attr;
+}
+
+int waddcells(WINDOW *win, const PDC_CELL *cells, int n)
+{
+    int i;
+
+    PDC_LOG(("waddcells() - called: win=%p n=%d\n", win, n));
+
+    if (!win || !cells || n < 0)
+        return ERR;
+
+    for (i = 0; i < n; i++)
+        if (cells[i].y < 0 || cells[i].y >= win->_maxy ||
+            cells[i].x < 0 || cells[i].x >= win->_maxx)
+            return ERR;
+
+    for (i = 0; i < n; i++)
+    {
+        int y = cells[i].y;
+        int x = cells[i].x;
+        chtype text = _merge(win, cells[i].ch);
+
+        if (win->_y[y][x] != text || PDC_SIDE_DIFF(win, y, x))
+        {
+            if (win->_firstch[y] == _NO_CHANGE)
+                win->_firstch[y] = win->_lastch[y] = x;
+            else
+                if (x < win->_firstch[y])
+                    win->_firstch[y] = x;
+                else
+                    if (x > win->_lastch[y])
+                        win->_lastch[y] = x;
+
+            win->_y[y][x] = text;
+
+            if (win->_side)
+                win->_side[y][x] = win->_sideattr;
+        }
+    }
+
+    PDC_sync(win);
+
+    return OK;
+}
+
+int waddchrect(WINDOW *win, int y, int x, int nlines, int ncols,
+               const chtype *ch, int stride)
+{
+    int i, j, minx, maxx;
+
+    PDC_LOG(("waddchrect() - called: win=%p y %d x %d nlines %d "
+             "ncols %d stride %d\n", win, y, x, nlines, ncols, stride));
+
+    if (!stride)
+        stride = ncols;
+
+    if (!win || !ch || y < 0 || x < 0 || nlines < 0 || ncols < 0 ||
+        stride < ncols || nlines > win->_maxy - y ||
+        ncols > win->_maxx - x)
+        return ERR;
+
+    for (i = 0; i < nlines; i++, y++, ch += stride)
+    {
+        chtype *ptr = win->_y[y] + x;
+
+        minx = _NO_CHANGE;
+        maxx = _NO_CHANGE;
+
+        for (j = 0; j < ncols; j++)
+        {
+            chtype text = _merge(win, ch[j]);
+
+            if (ptr[j] != text || PDC_SIDE_DIFF(win, y, x + j))
+            {
+                if (minx == _NO_CHANGE)
+                    minx = j;
+
+                maxx = j;
+                ptr[j] = text;
+
+                if (win->_side)
+                    win->_side[y][x + j] = win->_sideattr;
+            }
+        }
+
+        if (minx != _NO_CHANGE)
+        {
+            minx += x;
+            maxx += x;
+
+            if (win->_firstch[y] == _NO_CHANGE)
+            {
+                win->_firstch[y] = minx;
+                win->_lastch[y] = maxx;
+            }
+            else
+            {
+                if (minx < win->_firstch[y])
+                    win->_firstch[y] = minx;
+
+                if (maxx > win->_lastch[y])
+                    win->_lastch[y] = maxx;
+            }
+        }
+    }
+
+    PDC_sync(win);
+
+    return OK;
+}
+
 int addchstr(const chtype *ch)
 {
     PDC_LOG(("addchstr() - called\n"));
@@ -49,6 +49,9 @@ attr
     int underscore(void);
     int wunderscore(WINDOW *win);
 
+    int wrgb_set(WINDOW *win, int fg, int bg);
+    int wrgb_get(WINDOW *win, int *fg, int *bg);
+
 ### Description
 
    These functions manipulate the current attributes and/or colors of
@@ -68,16 +71,22 @@ attr
    wattroff() turns off the named attributes without affecting any other
    attributes; wattron() turns them on.
 
-   wcolor_set() sets the window color to the value of color_pair. opts
-   is unused.
+   wcolor_set() sets the window color to the value of color_pair. If
+   opts is not NULL, it points to an int holding the color pair, which
+   is used instead of color_pair, and may be an extended pair (see
+   init_extended_pair()). An extended pair is kept apart from the
+   A_COLOR bits, which are left clear; turning on or off any of those
+   bits, as with wattron(), or setting them with wattrset(), drops it.
 
    standout() is the same as attron(A_STANDOUT). standend() is the same
    as attrset(A_NORMAL); that is, it turns off all attributes.
 
    The attr_* and wattr_* functions are intended for use with the WA_*
    attributes. In PDCurses, these are the same as A_*, and there is no
-   difference in bevahior from the chtype-based functions. In all cases,
-   opts is unused.
+   difference in bevahior from the chtype-based functions. wattr_set()
+   takes opts as wcolor_set() does; wattr_get() stores the color pair
+   in the int that opts points to, if it is not NULL. In wattr_on() and
+   wattr_off(), opts is unused.
 
    wattr_get() retrieves the attributes and color pair for the specified
    window.
@@ -86,11 +95,22 @@ attr
    the current line of a given window, without changing the existing
    text, or alterting the window's attributes. An n of -1 extends the
    change to the edge of the window. The changes take effect
-   immediately. opts is unused.
+   immediately. opts is used as in wcolor_set().
 
    wunderscore() turns on the A_UNDERLINE attribute; wunderend() turns
    it off. underscore() and underend() are the stdscr versions.
 
+   wrgb_set() sets direct colors for the cells written into the window
+   from now on, where PDC_has_rgb_color() is TRUE. fg and bg are each a
+   PDC_RGB_COLOR(r, g, b) value, drawn in place of that color of the
+   cell's pair, or -1 to keep the pair's color; so wrgb_set(win, -1, -1)
+   turns them off. They're kept in the side plane beside the cells (see
+   init_extended_pair()), and use no color pairs, so any number of them
+   can be on the screen at once. Cells blanked by clearing, scrolling,
+   insertion or deletion have none. As with pair colors, A_REVERSE
+   swaps them; A_BOLD and A_BLINK don't brighten them. wrgb_get() gets
+   them, as -1 for none.
+
 ### Return Value
 
    All functions return OK on success and ERR on error.
@@ -128,6 +148,8 @@ attr
    wunderend             |    -   |    -    |   Y
    underscore            |    -   |    -    |   Y
    wunderscore           |    -   |    -    |   Y
+   wrgb_set              |    -   |    -    |   -
+   wrgb_get              |    -   |    -    |   -
 
 **man-end****************************************************************/
 
@@ -140,6 +162,9 @@ int wattroff(WINDOW *win, chtype attrs)
 
     win->_attrs &= (~attrs & A_ATTRIBUTES);
 
+    if (attrs & A_COLOR)
+        win->_sideattr.pair = 0;
+
     return OK;
 }
 
@@ -171,6 +196,9 @@ int wattron(WINDOW *win, chtype attrs)
     else
         win->_attrs |= (attrs & A_ATTRIBUTES);
 
+    if (attrs & A_COLOR)
+        win->_sideattr.pair = 0;
+
     return OK;
 }
 
@@ -189,6 +217,7 @@ int wattrset(WINDOW *win, chtype attrs)
         return ERR;
 
     win->_attrs = attrs & A_ATTRIBUTES;
+    win->_sideattr.pair = 0;
 
     return OK;
 }
@@ -233,14 +262,48 @@ chtype getattrs(WINDOW *win)
     return win ? win->_attrs : 0;
 }
 
+/* Split the pair given to wattr_set() and the like into the A_COLOR
+   bits for a chtype, and the pair for a side cell -- one of which is
+   0 -- turning the side planes on if they're needed. Returns FALSE if
+   the pair is invalid, or the planes can't be made. */
+
+static bool _split_pair(short color_pair, const void *opts,
+                        chtype *color, int *side)
+{
+    int pair = PDC_opts_pair(color_pair, opts);
+
+    if (pair == -1)
+        return FALSE;
+
+    if (pair < PDC_COLOR_PAIRS)
+    {
+        *color = COLOR_PAIR(pair);
+        *side = 0;
+    }
+    else
+    {
+        if (!PDC_side_enable())
+            return FALSE;
+
+        *color = 0;
+        *side = pair;
+    }
+
+    return TRUE;
+}
+
 int wcolor_set(WINDOW *win, short color_pair, void *opts)
 {
+    chtype color;
+    int side;
+
     PDC_LOG(("wcolor_set() - called\n"));
 
-    if (!win)
+    if (!win || !_split_pair(color_pair, opts, &color, &side))
         return ERR;
 
-    win->_attrs = (win->_attrs & ~A_COLOR) | COLOR_PAIR(color_pair);
+    win->_attrs = (win->_attrs & ~A_COLOR) | color;
+    win->_sideattr.pair = side;
 
     return OK;
 }
@@ -254,6 +317,8 @@ int color_set(short color_pair, void *opts)
 
 int wattr_get(WINDOW *win, attr_t *attrs, short *color_pair, void *opts)
 {
+    int pair;
+
     PDC_LOG(("wattr_get() - called\n"));
 
     if (!win)
@@ -262,8 +327,14 @@ int wattr_get(WINDOW *win, attr_t *attrs, short *color_pair, void *opts)
     if (attrs)
         *attrs = win->_attrs & (A_ATTRIBUTES & ~A_COLOR);
 
+    pair = win->_sideattr.pair ? win->_sideattr.pair :
+                                 (int)PAIR_NUMBER(win->_attrs);
+
     if (color_pair)
-        *color_pair = PAIR_NUMBER(win->_attrs);
+        *color_pair = pair;
+
+    if (opts)
+        *((int *)opts) = pair;
 
     return OK;
 }
@@ -305,12 +376,16 @@ int attr_on(attr_t attrs, void *opts)
 
 int wattr_set(WINDOW *win, attr_t attrs, short color_pair, void *opts)
 {
+    chtype color;
+    int side;
+
     PDC_LOG(("wattr_set() - called\n"));
 
-    if (!win)
+    if (!win || !_split_pair(color_pair, opts, &color, &side))
         return ERR;
 
-    win->_attrs = (attrs & (A_ATTRIBUTES & ~A_COLOR)) | COLOR_PAIR(color_pair);
+    win->_attrs = (attrs & (A_ATTRIBUTES & ~A_COLOR)) | color;
+    win->_sideattr.pair = side;
 
     return OK;
 }
@@ -324,15 +399,15 @@ int attr_set(attr_t attrs, short color_pair, void *opts)
 
 int wchgat(WINDOW *win, int n, attr_t attr, short color, const void *opts)
 {
-    chtype *dest, newattr;
-    int startpos, endpos;
+    chtype *dest, newattr, newcolor;
+    int startpos, endpos, side;
 
     PDC_LOG(("wchgat() - called\n"));
 
-    if (!win)
+    if (!win || !_split_pair(color, opts, &newcolor, &side))
         return ERR;
 
-    newattr = (attr & (A_ATTRIBUTES & ~A_COLOR)) | COLOR_PAIR(color);
+    newattr = (attr & (A_ATTRIBUTES & ~A_COLOR)) | newcolor;
 
     startpos = win->_curx;
     endpos = ((n < 0) ? win->_maxx : min(startpos + n, win->_maxx)) - 1;
@@ -341,6 +416,10 @@ int wchgat(WINDOW *win, int n, attr_t attr, short color, const void *opts)
     for (n = startpos; n <= endpos; n++)
         dest[n] = (dest[n] & A_CHARTEXT) | newattr;
 
+    if (win->_side)
+        for (n = startpos; n <= endpos; n++)
+            win->_side[win->_cury][n].pair = side;
+
     n = win->_cury;
 
     if (startpos < win->_firstch[n] || win->_firstch[n] == _NO_CHANGE)
@@ -409,3 +488,46 @@ int wunderscore(WINDOW *win)
 
     return wattron(win, A_UNDERLINE);
 }
+
+static bool _valid_rgb(int color)
+{
+    return color == -1 || (PDC_IS_RGB(color) &&
+        color <= PDC_RGB_COLOR(255, 255, 255) && PDC_has_rgb_color());
+}
+
+int wrgb_set(WINDOW *win, int fg, int bg)
+{
+    PDC_LOG(("wrgb_set() - called: fg %x bg %x\n", fg, bg));
+
+    if (!win || !_valid_rgb(fg) || !_valid_rgb(bg))
+        return ERR;
+
+    if (fg == -1)
+        fg = 0;
+
+    if (bg == -1)
+        bg = 0;
+
+    /* the planes are made only when there's something to put in them */
+
+    if ((fg || bg) && !PDC_side_enable())
+        return ERR;
+
+    win->_sideattr.f = fg;
+    win->_sideattr.b = bg;
+
+    return OK;
+}
+
+int wrgb_get(WINDOW *win, int *fg, int *bg)
+{
+    PDC_LOG(("wrgb_get() - called\n"));
+
+    if (!win || !fg || !bg)
+        return ERR;
+
+    *fg = win->_sideattr.f ? win->_sideattr.f : -1;
+    *bg = win->_sideattr.b ? win->_sideattr.b : -1;
+
+    return OK;
+}
@@ -112,9 +112,10 @@ int wbkgd(WINDOW *win, chtype ch)
             attr = ch & (A_ATTRIBUTES ^ A_COLOR);
 
             /* if the color is the same as the old background color,
-               then make it the new background color, otherwise leave it */
+               then make it the new background color, otherwise leave it;
+               a cell in an extended pair has a color of its own */
 
-            if (colr == oldcolr)
+            if (colr == oldcolr && !(win->_side && win->_side[y][x].pair))
                 colr = newcolr;
 
             /* remove any attributes (non color) from the character that
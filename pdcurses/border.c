@@ -128,7 +128,7 @@ static chtype _attr_passthru(WINDOW *win, chtype ch)
        background, in that it only takes precedence if other color
        attributes are not there. */
 
-    if (!(attr & A_COLOR))
+    if (!(attr & A_COLOR) && !win->_sideattr.pair)
         attr |= win->_bkgd & A_ATTRIBUTES;
     else
         attr |= win->_bkgd & (A_ATTRIBUTES ^ A_COLOR);
@@ -177,6 +177,21 @@ int wborder(WINDOW *win, chtype ls, chtype rs, chtype ts, chtype bs,
     win->_y[ymax][0] = bl;
     win->_y[ymax][xmax] = br;
 
+    if (win->_side)
+    {
+        for (i = 0; i <= xmax; i++)
+        {
+            win->_side[0][i] = win->_sideattr;
+            win->_side[ymax][i] = win->_sideattr;
+        }
+
+        for (i = 1; i < ymax; i++)
+        {
+            win->_side[i][0] = win->_sideattr;
+            win->_side[i][xmax] = win->_sideattr;
+        }
+    }
+
     for (i = 0; i <= ymax; i++)
     {
         win->_firstch[i] = 0;
@@ -223,6 +238,14 @@ int whline(WINDOW *win, chtype ch, int n)
 
     n = win->_cury;
 
+    if (win->_side)
+    {
+        int x;
+
+        for (x = startpos; x <= endpos; x++)
+            win->_side[n][x] = win->_sideattr;
+    }
+
     if (startpos < win->_firstch[n] || win->_firstch[n] == _NO_CHANGE)
         win->_firstch[n] = startpos;
 
@@ -279,6 +302,9 @@ int wvline(WINDOW *win, chtype ch, int n)
     {
         win->_y[n][x] = ch;
 
+        if (win->_side)
+            win->_side[n][x] = win->_sideattr;
+
         if (x < win->_firstch[n] || win->_firstch[n] == _NO_CHANGE)
             win->_firstch[n] = x;
 
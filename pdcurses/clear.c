@@ -52,6 +52,8 @@ clear
 
 **man-end****************************************************************/
 
+#include <string.h>
+
 int wclrtoeol(WINDOW *win)
 {
     int x, y, minx;
@@ -73,6 +75,9 @@ int wclrtoeol(WINDOW *win)
     for (minx = x, ptr = &win->_y[y][x]; minx < win->_maxx; minx++, ptr++)
         *ptr = blank;
 
+    if (win->_side)
+        memset(win->_side[y] + x, 0, (win->_maxx - x) * sizeof(PDC_SIDE));
+
     if (x < win->_firstch[y] || win->_firstch[y] == _NO_CHANGE)
         win->_firstch[y] = x;
 
@@ -19,11 +19,14 @@ color
 
     int alloc_pair(int fg, int bg);
     int assume_default_colors(int f, int b);
+    int extended_pair_content(int pair, int *fg, int *bg);
     int find_pair(int fg, int bg);
     int free_pair(int pair);
+    int init_extended_pair(int pair, int fg, int bg);
     int use_default_colors(void);
 
     int PDC_set_line_color(short color);
+    bool PDC_has_rgb_color(void);
 
 ### Description
 
@@ -75,8 +78,30 @@ color
    free_pair() marks a pair as unused; find_pair() returns an existing
    pair with the specified foreground and background colors, if one
    exists. And alloc_pair() returns such a pair whether or not it was
-   previously set, overwriting the oldest initialized pair if there are
-   no free pairs.
+   previously set, overwriting the least recently used pair if there
+   are no free pairs -- the one least recently set, or returned by
+   alloc_pair().
+
+   init_extended_pair() and extended_pair_content() are the ncurses
+   versions of init_pair() and pair_content() that take int arguments.
+   COLOR_PAIR() has room for only 256 pairs; higher pair numbers, up to
+   32766, can be used by passing a pointer to an int holding the pair
+   through the opts argument of wattr_set(), wcolor_set() or wchgat().
+   Defining or using such a pair, or passing any pair through opts,
+   raises COLOR_PAIRS to 32767, and from then on alloc_pair() hands out
+   the higher pairs first. A cell's pair is kept in its A_COLOR bits if
+   it fits, and otherwise in a "side plane" of per-cell data beside the
+   window's lines, which every window gets when a pair of 256 or more
+   is first used. So any number of extended pairs can be on the screen
+   at once. A cell in an extended pair has no A_COLOR bits, so a chtype
+   or cchar_t, as from winch() or setcchar(), can't carry its pair.
+
+   On backends that can show any 24-bit color, PDC_has_rgb_color()
+   returns TRUE, and wrgb_set() can give cells PDC_RGB_COLOR(r, g, b)
+   values, with each component from 0 to 255, in place of their pair's
+   colors. These are drawn as given, without going through the palette,
+   and so are not affected by init_color(), A_BOLD or A_BLINK. They're
+   kept in the side plane, so they use no pairs.
 
    PDC_set_line_color() is used to set the color, globally, for the
    color of the lines drawn for the attributes: A_UNDERLINE, A_LEFT and
@@ -87,9 +112,9 @@ color
 
 ### Return Value
 
-   Most functions return OK on success and ERR on error. has_colors()
-   and can_change_colors() return TRUE or FALSE. alloc_pair() and
-   find_pair() return a pair number, or -1 on error.
+   Most functions return OK on success and ERR on error. has_colors(),
+   can_change_colors() and PDC_has_rgb_color() return TRUE or FALSE.
+   alloc_pair() and find_pair() return a pair number, or -1 on error.
 
 ### Portability
 
@@ -104,10 +129,13 @@ color
    color_content         |    Y   |    Y    |   Y
    alloc_pair            |    -   |    Y    |   -
    assume_default_colors |    -   |    Y    |   Y
+   extended_pair_content |    -   |    Y    |   -
    find_pair             |    -   |    Y    |   -
    free_pair             |    -   |    Y    |   -
+   init_extended_pair    |    -   |    Y    |   -
    use_default_colors    |    -   |    Y    |   Y
    PDC_set_line_color    |    -   |    -    |   -
+   PDC_has_rgb_color     |    -   |    -    |   -
 
 **man-end****************************************************************/
 
@@ -149,41 +177,172 @@ static void _normalize(short *fg, short *bg)
         *bg = SP->orig_attr ? SP->orig_back : COLOR_BLACK;
 }
 
-static void _init_pair_core(short pair, short fg, short bg)
+static void _default_colors(short *fg, short *bg)
+{
+    if (SP->color_started && !default_colors)
+    {
+        *fg = COLOR_WHITE;
+        *bg = COLOR_BLACK;
+    }
+    else
+        *fg = *bg = -1;
+
+    _normalize(fg, bg);
+}
+
+/* Set pairs are indexed by a hash of (fg, bg), chained through hnext;
+   the bucket heads are kept in the hhead fields of the table itself.
+   All pairs but 0 are also on a circular list, headed by pair 0, in
+   the order alloc_pair() should reuse them: free pairs at the front,
+   then set pairs from least to most recently used. A pair is used when
+   it's set, and when alloc_pair() returns it. */
+
+static int _hash(short fg, short bg)
+{
+    return ((unsigned)(unsigned short)fg * 33 + (unsigned short)bg) %
+           (unsigned)COLOR_PAIRS;
+}
+
+static void _hash_insert(int pair)
+{
+    PDC_PAIR *p = SP->atrtab;
+    int h = _hash(p[pair].f, p[pair].b);
+
+    p[pair].hnext = p[h].hhead;
+    p[h].hhead = pair;
+}
+
+static void _hash_remove(int pair)
+{
+    PDC_PAIR *p = SP->atrtab;
+    int *link = &(p[_hash(p[pair].f, p[pair].b)].hhead);
+
+    while (*link != pair)
+        link = &(p[*link].hnext);
+
+    *link = p[pair].hnext;
+}
+
+static void _list_move(int pair, bool to_end)
+{
+    PDC_PAIR *p = SP->atrtab;
+    int after;
+
+    p[p[pair].prev].next = p[pair].next;
+    p[p[pair].next].prev = p[pair].prev;
+
+    after = to_end ? p[0].prev : 0;
+
+    p[pair].prev = after;
+    p[pair].next = p[after].next;
+    p[p[after].next].prev = pair;
+    p[after].next = pair;
+}
+
+/* Enlarge the table to PDC_EXT_PAIRS. The new free pairs go to the
+   front of the list, so that alloc_pair() hands them out first. */
+
+static bool _extend(void)
+{
+    PDC_PAIR *p;
+    short fg, bg;
+    int i, old = COLOR_PAIRS;
+
+    if (old >= PDC_EXT_PAIRS)
+        return TRUE;
+
+    if ((size_t)-1 / sizeof(PDC_PAIR) < (size_t)PDC_EXT_PAIRS)
+        return FALSE;
+
+    p = realloc(SP->atrtab, PDC_EXT_PAIRS * sizeof(PDC_PAIR));
+    if (!p)
+        return FALSE;
+
+    SP->atrtab = p;
+    COLOR_PAIRS = PDC_EXT_PAIRS;
+
+    _default_colors(&fg, &bg);
+
+    for (i = old; i < COLOR_PAIRS; i++)
+    {
+        p[i].f = fg;
+        p[i].b = bg;
+        p[i].count = 0;
+        p[i].set = FALSE;
+        p[i].prev = i - 1;
+        p[i].next = i + 1;
+    }
+
+    p[old].prev = 0;
+    p[COLOR_PAIRS - 1].next = p[0].next;
+    p[p[0].next].prev = COLOR_PAIRS - 1;
+    p[0].next = old;
+
+    /* Rehash, now that there are more buckets */
+
+    for (i = 0; i < COLOR_PAIRS; i++)
+        p[i].hhead = -1;
+
+    for (i = 0; i < COLOR_PAIRS; i++)
+        if (p[i].set)
+            _hash_insert(i);
+
+    return TRUE;
+}
+
+static void _init_pair_core(int pair, short fg, short bg)
 {
     PDC_PAIR *p = SP->atrtab + pair;
 
     _normalize(&fg, &bg);
 
-    /* To allow the PDC_PRESERVE_SCREEN option to work, we only reset
-       curscr if this call to init_pair() alters a color pair created by
-       the user. */
+    /* To allow the PDC_PRESERVE_SCREEN option to work, we only repaint
+       if this call to init_pair() alters a color pair created by the
+       user. */
 
     if (p->set)
     {
         if (p->f != fg || p->b != bg)
-            curscr->_clear = TRUE;
+            PDC_pair_changed(pair);
+
+        _hash_remove(pair);
     }
 
     p->f = fg;
     p->b = bg;
     p->count = allocnum++;
     p->set = TRUE;
+
+    _hash_insert(pair);
+
+    if (pair)
+        _list_move(pair, TRUE);
 }
 
-int init_pair(short pair, short fg, short bg)
+int init_extended_pair(int pair, int fg, int bg)
 {
-    PDC_LOG(("init_pair() - called: pair %d fg %d bg %d\n", pair, fg, bg));
+    PDC_LOG(("init_extended_pair() - called: pair %d fg %d bg %d\n",
+             pair, fg, bg));
 
-    if (!SP || !SP->color_started || pair < 1 || pair >= COLOR_PAIRS ||
+    if (!SP || !SP->color_started || pair < 1 || pair >= PDC_EXT_PAIRS ||
         fg < first_col || fg >= COLORS || bg < first_col || bg >= COLORS)
         return ERR;
 
+    if (pair >= COLOR_PAIRS && !_extend())
+        return ERR;
+
     _init_pair_core(pair, fg, bg);
 
     return OK;
 }
 
+int init_pair(short pair, short fg, short bg)
+{
+    PDC_LOG(("init_pair() - called: pair %d fg %d bg %d\n", pair, fg, bg));
+
+    return init_extended_pair(pair, fg, bg);
+}
+
 bool has_colors(void)
 {
     PDC_LOG(("has_colors() - called\n"));
@@ -200,6 +359,23 @@ int init_color(short color, short red, short green, short blue)
         blue < -1 || blue > 1000)
         return ERR;
 
+    /* Repaint the cells that show this color -- directly, or as the
+       brightened form of color - 8 that A_BOLD or A_BLINK may give */
+
+    if (color == SP->line_color)
+        curscr->_clear = TRUE;
+    else
+    {
+        PDC_PAIR *p = SP->atrtab;
+        short dim = (color >= 8 && color < 16) ? color - 8 : color;
+        int i;
+
+        for (i = 0; i < COLOR_PAIRS; i++)
+            if (p[i].f == color || p[i].b == color ||
+                p[i].f == dim || p[i].b == dim)
+                PDC_pair_changed(i);
+    }
+
     SP->dirty = TRUE;
 
     return PDC_init_color(color, red, green, blue);
@@ -236,9 +412,9 @@ bool can_change_color(void)
     return PDC_can_change_color();
 }
 
-int pair_content(short pair, short *fg, short *bg)
+int extended_pair_content(int pair, int *fg, int *bg)
 {
-    PDC_LOG(("pair_content() - called\n"));
+    PDC_LOG(("extended_pair_content() - called\n"));
 
     if (pair < 0 || pair >= COLOR_PAIRS || !fg || !bg)
         return ERR;
@@ -249,6 +425,21 @@ int pair_content(short pair, short *fg, short *bg)
     return OK;
 }
 
+int pair_content(short pair, short *fg, short *bg)
+{
+    int f, b;
+
+    PDC_LOG(("pair_content() - called\n"));
+
+    if (!fg || !bg || extended_pair_content(pair, &f, &b) == ERR)
+        return ERR;
+
+    *fg = f;
+    *bg = b;
+
+    return OK;
+}
+
 int assume_default_colors(int f, int b)
 {
     PDC_LOG(("assume_default_colors() - called: f %d b %d\n", f, b));
@@ -284,81 +475,98 @@ int PDC_set_line_color(short color)
     return OK;
 }
 
+bool PDC_has_rgb_color(void)
+{
+    PDC_LOG(("PDC_has_rgb_color() - called\n"));
+
+    return SP ? SP->rgb_color && !(SP->mono) : FALSE;
+}
+
 void PDC_init_atrtab(void)
 {
     PDC_PAIR *p = SP->atrtab;
-    short i, fg, bg;
-
-    if (SP->color_started && !default_colors)
-    {
-        fg = COLOR_WHITE;
-        bg = COLOR_BLACK;
-    }
-    else
-        fg = bg = -1;
+    short fg, bg;
+    int i;
 
-    _normalize(&fg, &bg);
+    _default_colors(&fg, &bg);
 
-    for (i = 0; i < PDC_COLOR_PAIRS; i++)
+    for (i = 0; i < COLOR_PAIRS; i++)
     {
         p[i].f = fg;
         p[i].b = bg;
+        p[i].count = allocnum++;
         p[i].set = FALSE;
+        p[i].prev = i - 1;
+        p[i].next = i + 1;
+        p[i].hnext = p[i].hhead = -1;
     }
+
+    p[0].prev = COLOR_PAIRS - 1;
+    p[COLOR_PAIRS - 1].next = 0;
 }
 
 int free_pair(int pair)
 {
-    if (pair < 1 || pair >= PDC_COLOR_PAIRS || !(SP->atrtab[pair].set))
+    if (pair < 1 || pair >= COLOR_PAIRS || !(SP->atrtab[pair].set))
         return ERR;
 
+    _hash_remove(pair);
+    _list_move(pair, FALSE);
+
     SP->atrtab[pair].set = FALSE;
     return OK;
 }
 
 int find_pair(int fg, int bg)
 {
+    short f = fg, b = bg;
     int i;
     PDC_PAIR *p = SP->atrtab;
 
-    for (i = 0; i < PDC_COLOR_PAIRS; i++)
-        if (p[i].set && p[i].f == fg && p[i].b == bg)
+    _normalize(&f, &b);
+
+    for (i = p[_hash(f, b)].hhead; i != -1; i = p[i].hnext)
+        if (p[i].f == f && p[i].b == b)
             return i;
 
     return -1;
 }
 
-static int _find_oldest()
+int alloc_pair(int fg, int bg)
 {
-    int i, lowind = 0, lowval = 0;
-    PDC_PAIR *p = SP->atrtab;
+    int i = find_pair(fg, bg);
 
-    for (i = 1; i < PDC_COLOR_PAIRS; i++)
+    if (-1 == i)
     {
-        if (!p[i].set)
-            return i;
+        /* The head of the list is a free pair if there is one, else
+           the least recently used pair */
 
-        if (!lowval || (p[i].count < lowval))
-        {
-            lowind = i;
-            lowval = p[i].count;
-        }
+        i = SP->atrtab[0].next;
+
+        if (ERR == init_extended_pair(i, fg, bg))
+            return -1;
     }
+    else if (i)
+        _list_move(i, TRUE);
 
-    return lowind;
+    return i;
 }
 
-int alloc_pair(int fg, int bg)
+/* Return the pair given to wattr_set() and the like: color_pair, or
+   the int that opts points to, if given. Passing opts, or a pair that
+   doesn't fit in a chtype, enlarges the table, so that alloc_pair()
+   can hand out the extended pairs. Returns -1 if the pair is invalid,
+   or the table can't be enlarged. */
+
+int PDC_opts_pair(short color_pair, const void *opts)
 {
-    int i = find_pair(fg, bg);
+    int pair = opts ? *((const int *)opts) : color_pair;
 
-    if (-1 == i)
-    {
-        i = _find_oldest();
+    if (!opts && pair >= 0 && pair < PDC_COLOR_PAIRS)
+        return pair;
 
-        if (ERR == init_pair(i, fg, bg))
-            return -1;
-    }
+    if (!SP || pair < 0 || pair >= PDC_EXT_PAIRS || !_extend())
+        return -1;
 
-    return i;
+    return pair;
 }
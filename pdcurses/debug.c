@@ -13,6 +13,10 @@ debug
     void traceoff(void);
     void PDC_debug(const char *, ...);
 
+    int PDC_trace_start(int size);
+    int PDC_trace_stop(void);
+    int PDC_trace_dump(const char *filename);
+
 ### Description
 
    traceon() and traceoff() toggle the recording of debugging
@@ -26,6 +30,28 @@ debug
    file contents are fflushed after each write. The default is not. Set
    it to enable this (may affect performance).
 
+   PDC_trace_start() turns on binary tracing, which, unlike traceon(),
+   works without a PDCDEBUG build, and is cheap enough to leave on while
+   chasing timing problems. Each traced event adds a fixed-size record,
+   with an event number, a microsecond count and up to three values, to
+   a ring of size records (65536 if size is 0), overwriting the oldest
+   once it's full. The events are doupdate() and each run of cells it
+   draws, wnoutrefresh(), wredrawln(), scrolled and moved regions, the
+   mouse selection, wgetch() with its wait for input and the key it
+   returns, the input events read from the platform, ungetch(), flushinp(),
+   napms(), resize_term(), PDC_post_key(), PDC_set_paste_mode(), and
+   changes to color pairs. Records may be added from any thread, without
+   locking where the compiler has atomic operations. If tracing was
+   started before, size is ignored, and the records so far are kept.
+   PDC_trace_stop() pauses tracing.
+
+   PDC_trace_dump() writes the records in the ring to a file, oldest
+   first, after a header giving the clock's ticks per second, in a
+   binary form that the tracedump program (demos/tracedump.c,
+   which needs no curses library) turns into text. If the environment
+   variable PDC_TRACE is set when initscr() is called, tracing starts
+   then, and at exit, the trace is dumped to the file it names.
+
 ### Portability
 
    Function              | X/Open | ncurses | NetBSD
@@ -33,6 +59,9 @@ debug
    traceon               |    -   |    -    |   -
    traceoff              |    -   |    -    |   -
    PDC_debug             |    -   |    -    |   -
+   PDC_trace_start       |    -   |    -    |   -
+   PDC_trace_stop        |    -   |    -    |   -
+   PDC_trace_dump        |    -   |    -    |   -
 
 **man-end****************************************************************/
 
@@ -106,3 +135,179 @@ void traceoff(void)
     SP->dbfp = NULL;
     want_fflush = FALSE;
 }
+
+/* The binary trace. A writer claims a position by advancing
+   trace_head, and marks the record complete by setting its seq to the
+   position + 1, as PDC_post_key() does with its queue. */
+
+typedef struct
+{
+    volatile unsigned long seq;
+    unsigned long stamp;        /* PDC_us_count() */
+    long event, a, b, c;
+} TRACE_REC;
+
+static TRACE_REC *trace_ring = NULL;
+static unsigned long trace_size = 0;
+static volatile unsigned long trace_head = 0;
+static char *trace_exit_file = NULL;
+
+/* each event's name, then the names of its values; written to the
+   dump, so that tracedump needn't know them */
+
+static const char *trace_names[PDC_EV_COUNT] =
+{
+    "doupdate clearall",
+    "line y x len",
+    "doupdate_end",
+    "wait ms",
+    "wait_end left found",
+    "key key key_code",
+    "post_key key result",
+    "napms ms",
+    "resize lines cols",
+    "pair_changed pair",
+    "wnoutrefresh y x lines",
+    "redrawln y lines",
+    "move_hint y toy lines",
+    "selection start end",
+    "wgetch ms",
+    "ungetch key",
+    "flushinp",
+    "paste_mode on",
+    "input event code"
+};
+
+void PDC_trace(int event, long a, long b, long c)
+{
+    TRACE_REC *rec;
+    unsigned long pos;
+
+    do
+    {
+        pos = trace_head;
+    } while (!PDC_CAS(&trace_head, pos, pos + 1));
+
+    rec = trace_ring + pos % trace_size;
+
+    rec->seq = 0;
+    PDC_FENCE();
+
+    rec->stamp = PDC_us_count();
+    rec->event = event;
+    rec->a = a;
+    rec->b = b;
+    rec->c = c;
+
+    PDC_FENCE();
+    rec->seq = pos + 1;
+}
+
+static void _trace_dump_at_exit(void)
+{
+    PDC_trace_dump(trace_exit_file);
+}
+
+int PDC_trace_start(int size)
+{
+    const char *env;
+
+    PDC_LOG(("PDC_trace_start() - called: size %d\n", size));
+
+    if (!SP)
+        return ERR;
+
+    if (!trace_ring)
+    {
+        if (size <= 0)
+            size = 65536;
+
+        trace_ring = calloc(size, sizeof(TRACE_REC));
+        if (!trace_ring)
+            return ERR;
+
+        trace_size = size;
+    }
+
+    env = getenv("PDC_TRACE");
+
+    if (env && !trace_exit_file)
+    {
+        trace_exit_file = malloc(strlen(env) + 1);
+
+        if (trace_exit_file)
+        {
+            strcpy(trace_exit_file, env);
+            atexit(_trace_dump_at_exit);
+        }
+    }
+
+    SP->trace_on = TRUE;
+
+    return OK;
+}
+
+int PDC_trace_stop(void)
+{
+    PDC_LOG(("PDC_trace_stop() - called\n"));
+
+    if (!SP || !SP->trace_on)
+        return ERR;
+
+    SP->trace_on = FALSE;
+
+    return OK;
+}
+
+int PDC_trace_dump(const char *filename)
+{
+    static const char magic[8] = "PDCTRACE";
+    unsigned long head, pos, hdr[4];
+    FILE *fp;
+    int i;
+
+    PDC_LOG(("PDC_trace_dump() - called\n"));
+
+    if (!trace_ring || !filename)
+        return ERR;
+
+    fp = fopen(filename, "wb");
+    if (!fp)
+        return ERR;
+
+    /* the header shows the byte order and the size of a long, which
+       tracedump must share, and the clock the stamps come from:
+       PDC_us_count(), in ticks per second */
+
+    hdr[0] = 0x01020304UL;
+    hdr[1] = sizeof(long);
+    hdr[2] = PDC_EV_COUNT;
+    hdr[3] = 1000000UL;
+
+    fwrite(magic, 1, sizeof(magic), fp);
+    fwrite(hdr, sizeof(unsigned long), 4, fp);
+
+    for (i = 0; i < PDC_EV_COUNT; i++)
+        fwrite(trace_names[i], 1, strlen(trace_names[i]) + 1, fp);
+
+    head = trace_head;
+    pos = (head > trace_size) ? head - trace_size : 0;
+
+    for (; pos < head; pos++)
+    {
+        TRACE_REC rec = trace_ring[pos % trace_size];
+
+        /* skip records still being written */
+
+        if (rec.seq == pos + 1)
+            fwrite(&rec, sizeof(rec), 1, fp);
+    }
+
+    if (ferror(fp))
+    {
+        fclose(fp);
+        return ERR;
+    }
+
+    return fclose(fp) ? ERR : OK;
+}
@@ -60,6 +60,13 @@ int wdelch(WINDOW *win)
 
     win->_y[y][maxx] = win->_bkgd;
 
+    if (win->_side)
+    {
+        memmove(win->_side[y] + x, win->_side[y] + x + 1,
+                (maxx - x) * sizeof(PDC_SIDE));
+        memset(win->_side[y] + maxx, 0, sizeof(PDC_SIDE));
+    }
+
     win->_lastch[y] = maxx;
 
     if ((win->_firstch[y] == _NO_CHANGE) || (win->_firstch[y] > x))
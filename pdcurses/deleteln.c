@@ -55,9 +55,12 @@ deleteln
 
 **man-end****************************************************************/
 
+#include <string.h>
+
 int wdeleteln(WINDOW *win)
 {
     chtype blank, *temp, *ptr;
+    PDC_SIDE *stemp;
     int y;
 
     PDC_LOG(("wdeleteln() - called\n"));
@@ -70,10 +73,13 @@ int wdeleteln(WINDOW *win)
     blank = win->_bkgd;
 
     temp = win->_y[win->_cury];
+    stemp = win->_side ? win->_side[win->_cury] : NULL;
 
     for (y = win->_cury; y < win->_bmarg; y++)
     {
         win->_y[y] = win->_y[y + 1];
+        if (stemp)
+            win->_side[y] = win->_side[y + 1];
         win->_firstch[y] = 0;
         win->_lastch[y] = win->_maxx - 1;
     }
@@ -81,11 +87,16 @@ int wdeleteln(WINDOW *win)
     for (ptr = temp; (ptr - temp < win->_maxx); ptr++)
         *ptr = blank;           /* make a blank line */
 
+    if (stemp)
+        memset(stemp, 0, win->_maxx * sizeof(PDC_SIDE));
+
     if (win->_cury <= win->_bmarg)
     {
         win->_firstch[win->_bmarg] = 0;
         win->_lastch[win->_bmarg] = win->_maxx - 1;
         win->_y[win->_bmarg] = temp;
+        if (stemp)
+            win->_side[win->_bmarg] = stemp;
     }
 
     return OK;
@@ -154,6 +165,7 @@ int insdelln(int n)
 int winsertln(WINDOW *win)
 {
     chtype blank, *temp, *end;
+    PDC_SIDE *stemp;
     int y;
 
     PDC_LOG(("winsertln() - called\n"));
@@ -166,16 +178,25 @@ int winsertln(WINDOW *win)
     blank = win->_bkgd;
 
     temp = win->_y[win->_maxy - 1];
+    stemp = win->_side ? win->_side[win->_maxy - 1] : NULL;
 
     for (y = win->_maxy - 1; y > win->_cury; y--)
     {
         win->_y[y] = win->_y[y - 1];
+        if (stemp)
+            win->_side[y] = win->_side[y - 1];
         win->_firstch[y] = 0;
         win->_lastch[y] = win->_maxx - 1;
     }
 
     win->_y[win->_cury] = temp;
 
+    if (stemp)
+    {
+        win->_side[win->_cury] = stemp;
+        memset(stemp, 0, win->_maxx * sizeof(PDC_SIDE));
+    }
+
     for (end = &temp[win->_maxx - 1]; temp <= end; temp++)
         *temp = blank;
 
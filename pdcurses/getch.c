@@ -24,6 +24,11 @@ getch
 
     unsigned long PDC_get_key_modifiers(void);
     int PDC_return_key_modifiers(bool flag);
+    int PDC_post_key(int key);
+    int PDC_set_paste_mode(bool flag);
+    const char *PDC_get_paste_buffer(long *len);
+    int PDC_record_input(const char *filename);
+    int PDC_play_input(const char *filename, bool fast);
 
 ### Description
 
@@ -66,13 +71,51 @@ getch
    return modifier keys pressed alone as keystrokes (KEY_ALT_L, etc.).
    These may not work on all platforms.
 
+   PDC_post_key() adds a key to a queue that wgetch() reads from before
+   checking for real input, and wakes up a wgetch() that's waiting. It
+   may be called from any thread, so that others can feed keys, or
+   values of their own above KEY_MAX as "data ready" events, to the
+   one running curses; the keys from each thread are read in the order
+   posted. Values from KEY_MIN up are returned as function keys, i.e.,
+   only in keypad mode. The queue holds 256 keys; flushinp() leaves it
+   alone. It's lock-free where the compiler has atomic operations (GCC,
+   Clang and MSVC); elsewhere, it must be called from the curses thread.
+
+   Text pasted from the clipboard (with shift-ctrl-V, or a click of the
+   middle button with shift held, or none if the mouse isn't trapped)
+   normally comes back from getch() one character at a time, as if
+   typed. After PDC_set_paste_mode(TRUE), it comes all at once, as a
+   single KEY_PASTE -- in keypad mode; otherwise it's still one
+   character at a time. PDC_get_paste_buffer() then returns the text,
+   in the form PDC_getclipboard() gives it, and sets *len to its length
+   in bytes if len isn't NULL. The text is good until the next
+   KEY_PASTE, or delscreen(). Either way, with echo() on, the whole
+   paste is echoed and refreshed at once.
+
+   PDC_record_input() writes each event the platform gives wgetch() --
+   keys, with their modifiers, and mouse events and resizes, with their
+   details -- and the time since the one before, to the named file,
+   until it's called with NULL. Each event takes a few bytes. (Keys from
+   PDC_post_key() and ungetch() aren't recorded, since the program makes
+   them itself.) PDC_play_input() then feeds a recording back to
+   wgetch() in place of the platform's input, at the recorded pace, or
+   as fast as wgetch() asks for keys if fast is TRUE; real input waits
+   until the recording ends, or PDC_play_input(NULL, FALSE) stops it.
+   A resize is replayed by asking the platform for the recorded size.
+   If the environment variable PDC_RECORD_INPUT or PDC_PLAY_INPUT is
+   set when initscr() is called, recording or playback of the file it
+   names starts then; playback is fast if PDC_PLAY_FAST is also set.
+
    NOTE: getch() and ungetch() are implemented as macros, to avoid
    conflict with many DOS compiler's runtime libraries.
 
 ### Return Value
 
    These functions return ERR or the value of the character, meta
-   character or function key token.
+   character or function key token. PDC_post_key() returns OK, or ERR
+   if the queue is full. PDC_get_paste_buffer() returns NULL if there's
+   been no KEY_PASTE. PDC_record_input() and PDC_play_input() return
+   ERR if the file can't be opened, or isn't a recording.
 
 ### Portability
 
@@ -90,10 +133,68 @@ getch
    mvwget_wch            |    Y   |    Y    |   Y
    unget_wch             |    Y   |    Y    |   Y
    PDC_get_key_modifiers |    -   |    -    |   -
+   PDC_post_key          |    -   |    -    |   -
+   PDC_set_paste_mode    |    -   |    -    |   -
+   PDC_get_paste_buffer  |    -   |    -    |   -
+   PDC_record_input      |    -   |    -    |   -
+   PDC_play_input        |    -   |    -    |   -
 
 **man-end****************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+volatile long pdc_fence;
+#endif
+
+/* Keys from PDC_post_key(), in a ring. A poster claims a position by
+   advancing post_head, writes the key to the slot, then sets the
+   slot's seq to the position + 1 to show it's there. wgetch() is the
+   only reader, at post_tail. seq starts at 0, so no slot is full until
+   written. */
+
+#define POSTQ_SIZE 256
+
+static struct
+{
+    volatile unsigned long seq;
+    volatile int key;
+} postq[POSTQ_SIZE];
+
+static volatile unsigned long post_head = 0, post_tail = 0;
+static bool post_ready = FALSE;
+
+static bool paste_echoed = FALSE;   /* _paste() did the echoing */
+
+/* Input recording and playback. After an 8-byte header, each event is:
+   the microseconds since the one before, the key, and a flag byte (1:
+   key_code, 2: modifiers follow), each as a number; then the modifiers,
+   if any; then for KEY_MOUSE, x, y, the three buttons, changes and
+   mouse_count; or for KEY_RESIZE, the lines and columns. A number is
+   stored seven bits to a byte, low bits first, with the top bit set on
+   all but the last byte; signed values are zigzag-encoded. */
+
+#define INPUT_MAGIC "PDCINPUT"
+
+typedef struct
+{
+    unsigned long delay;      /* us since the event before */
+    int key;
+    bool key_code;
+    unsigned long modifiers;
+    MOUSE_STATUS mouse;
+    int mouse_count;
+    int lines, cols;
+} INPUT_REC;
+
+static FILE *rec_fp = NULL;
+static unsigned long rec_mark;      /* time of the last event recorded */
+
+static FILE *play_fp = NULL;
+static bool play_fast;
+static unsigned long play_mark;     /* when the last event was due */
+static INPUT_REC play_next;         /* the event to be played next */
 
 static int _get_box(int *y_start, int *y_end, int *x_start, int *x_end)
 {
@@ -119,21 +220,17 @@ static int _get_box(int *y_start, int *y_end, int *x_start, int *x_end)
     return (end - start) + (*y_end - *y_start);
 }
 
-static void _highlight(void)
-{
-    int i, j, y_start, y_end, x_start, x_end;
-
-    if (-1 == SP->sel_start)
-        return;
-
-    _get_box(&y_start, &y_end, &x_start, &x_end);
+/* set the selection, and show it over the screen; -1 for none */
 
-    for (j = y_start; j <= y_end; j++)
-        for (i = (j == y_start ? x_start : 0);
-             i < (j == y_end ? x_end : COLS); i++)
-            curscr->_y[j][i] ^= A_REVERSE;
+static void _select(int start, int end)
+{
+    SP->sel_start = start;
+    SP->sel_end = end;
 
-    wrefresh(curscr);
+    if (-1 == start)
+        PDC_show_selection(-1, -1);
+    else
+        PDC_show_selection(min(start, end), max(start, end));
 }
 
 static void _copy(void)
@@ -189,7 +286,7 @@ static void _copy(void)
 #endif
 }
 
-static int _paste(void)
+static int _paste(WINDOW *win)
 {
 #ifdef PDC_WIDE
     wchar_t *wpaste;
@@ -205,6 +302,29 @@ static int _paste(void)
     if (PDC_CLIP_SUCCESS != key || !len)
         return -1;
 
+    if (SP->echo)
+    {
+        waddnstr(win, paste, (int)len);
+        wrefresh(win);
+        paste_echoed = TRUE;
+    }
+
+    SP->key_modifiers = 0;
+
+    /* keep it whole for PDC_get_paste_buffer() */
+
+    if (SP->paste_mode && win->_use_keypad)
+    {
+        if (SP->paste_buf)
+            PDC_freeclipboard(SP->paste_buf);
+
+        SP->paste_buf = paste;
+        SP->paste_len = len;
+
+        SP->key_code = TRUE;
+        return KEY_PASTE;
+    }
+
 #ifdef PDC_WIDE
     wpaste = malloc(len * sizeof(wchar_t));
     len = PDC_mbstowcs(wpaste, paste, len);
@@ -224,12 +344,11 @@ static int _paste(void)
     free(wpaste);
 #endif
     PDC_freeclipboard(paste);
-    SP->key_modifiers = 0;
 
     return key;
 }
 
-static int _mouse_key(void)
+static int _mouse_key(WINDOW *win)
 {
     int i, key = KEY_MOUSE, changes = SP->mouse_status.changes;
     unsigned long mbe = SP->_trap_mbe;
@@ -242,13 +361,10 @@ static int _mouse_key(void)
         switch (SP->mouse_status.button[0] & BUTTON_ACTION_MASK)
         {
         case BUTTON_PRESSED:
-            _highlight();
-            SP->sel_start = SP->sel_end = i;
+            _select(i, i);
             return -1;
         case BUTTON_MOVED:
-            _highlight();
-            SP->sel_end = i;
-            _highlight();
+            _select(SP->sel_start, i);
             return -1;
         case BUTTON_RELEASED:
             _copy();
@@ -260,7 +376,7 @@ static int _mouse_key(void)
              BUTTON_ACTION_MASK) == BUTTON_CLICKED)
     {
         SP->key_code = FALSE;
-        return _paste();
+        return _paste(win);
     }
 
     /* Filter unwanted mouse events */
@@ -322,31 +438,342 @@ static int _mouse_key(void)
     return key;
 }
 
+/* Called from PDC_wait_key(), before it checks for real input */
+
+bool PDC_key_posted(void)
+{
+    unsigned long tail = post_tail;
+
+    post_ready = (postq[tail % POSTQ_SIZE].seq == tail + 1);
+
+    return post_ready;
+}
+
+static int _take_posted(void)
+{
+    unsigned long tail = post_tail;
+    int key = postq[tail % POSTQ_SIZE].key;
+
+    PDC_FENCE();
+    post_tail = tail + 1;
+
+    SP->key_code = (key >= KEY_MIN);
+    SP->key_modifiers = 0L;
+
+    return key;
+}
+
+static void _put_num(unsigned long n)
+{
+    while (n > 0x7f)
+    {
+        putc((int)(n & 0x7f) | 0x80, rec_fp);
+        n >>= 7;
+    }
+
+    putc((int)n, rec_fp);
+}
+
+static void _put_int(long n)
+{
+    _put_num(n < 0 ? ((unsigned long)~n << 1) | 1 : (unsigned long)n << 1);
+}
+
+static void _record(int key)
+{
+    unsigned long now = SP->key_time ? SP->key_time : PDC_us_count();
+    int i;
+
+    /* a platform's stamp may come from before the last event's */
+
+    if ((long)(now - rec_mark) < 0)
+        now = rec_mark;
+
+    _put_num(now - rec_mark);
+    _put_num((unsigned long)key);
+    _put_num((SP->key_code ? 1 : 0) | (SP->key_modifiers ? 2 : 0));
+
+    rec_mark = now;
+
+    if (SP->key_modifiers)
+        _put_num(SP->key_modifiers);
+
+    if (SP->key_code && key == KEY_MOUSE)
+    {
+        _put_int(SP->mouse_status.x);
+        _put_int(SP->mouse_status.y);
+
+        for (i = 0; i < 3; i++)
+            _put_num((unsigned short)SP->mouse_status.button[i]);
+
+        _put_num((unsigned long)SP->mouse_status.changes);
+        _put_num((unsigned long)SP->mouse_count);
+    }
+    else if (SP->key_code && key == KEY_RESIZE)
+    {
+        _put_num((unsigned long)PDC_get_rows());
+        _put_num((unsigned long)PDC_get_columns());
+    }
+
+    fflush(rec_fp);
+}
+
+static bool _get_num(unsigned long *n)
+{
+    int ch, shift = 0;
+
+    *n = 0;
+
+    do
+    {
+        ch = getc(play_fp);
+        if (ch == EOF || shift >= (int)(sizeof(long) * 8))
+            return FALSE;
+
+        *n |= (unsigned long)(ch & 0x7f) << shift;
+        shift += 7;
+    } while (ch & 0x80);
+
+    return TRUE;
+}
+
+static bool _get_int(int *n)
+{
+    unsigned long u;
+
+    if (!_get_num(&u))
+        return FALSE;
+
+    *n = (u & 1) ? (int)~(u >> 1) : (int)(u >> 1);
+
+    return TRUE;
+}
+
+/* read the next event into play_next; at the end, or on a bad record,
+   stop playing */
+
+static void _play_read(void)
+{
+    INPUT_REC *rec = &play_next;
+    unsigned long key = 0, flags = 0, n[5] = {0};
+    bool ok;
+    int i;
+
+    memset(rec, 0, sizeof(INPUT_REC));
+
+    ok = _get_num(&rec->delay) && _get_num(&key) && _get_num(&flags);
+
+    if (ok && (flags & 2))
+        ok = _get_num(&rec->modifiers);
+
+    rec->key = (int)key;
+    rec->key_code = !!(flags & 1);
+
+    if (ok && rec->key_code && rec->key == KEY_MOUSE)
+    {
+        ok = _get_int(&rec->mouse.x) && _get_int(&rec->mouse.y);
+
+        for (i = 0; ok && i < 5; i++)
+            ok = _get_num(n + i);
+
+        for (i = 0; i < 3; i++)
+            rec->mouse.button[i] = (short)n[i];
+
+        rec->mouse.changes = (int)n[3];
+        rec->mouse_count = (int)n[4];
+    }
+    else if (ok && rec->key_code && rec->key == KEY_RESIZE)
+    {
+        ok = _get_num(n) && _get_num(n + 1);
+
+        rec->lines = (int)n[0];
+        rec->cols = (int)n[1];
+    }
+
+    if (!ok)
+    {
+        fclose(play_fp);
+        play_fp = NULL;
+    }
+}
+
+/* PDC_wait_key(), for playback: wait until the next event is due, or a
+   key is posted. The sleeping is done by the platform's own wait, so
+   that it goes on handling its events; but once there's real input
+   (which is left for after playback), that wait returns at once, so
+   then it naps in short steps instead. */
+
+static bool _play_wait(int *ms)
+{
+    unsigned long start = PDC_ms_count();
+    int left = *ms;
+
+    for (;;)
+    {
+        unsigned long played = PDC_us_count() - play_mark;
+        bool ready = PDC_key_posted() || play_fast ||
+                     played >= play_next.delay;
+        int wait;
+
+        if (*ms >= 0)
+            left = max(*ms - (int)(PDC_ms_count() - start), 0);
+
+        if (ready)
+            break;
+
+        if (!left)
+            return FALSE;
+
+        wait = (int)((play_next.delay - played + 999) / 1000);
+
+        if (left >= 0 && left < wait)
+            wait = left;
+
+        if (PDC_wait_key(&wait) && !post_ready)
+            PDC_napms(min(wait, 10));
+    }
+
+    *ms = left;
+
+    return TRUE;
+}
+
+/* PDC_get_key(), for playback */
+
+static int _play_key(void)
+{
+    INPUT_REC *rec = &play_next;
+    int key = rec->key;
+
+    play_mark += rec->delay;
+
+    SP->key_code = rec->key_code;
+    SP->key_modifiers = rec->modifiers;
+
+    if (rec->key_code && key == KEY_MOUSE)
+    {
+        SP->mouse_status = rec->mouse;
+        SP->mouse_count = rec->mouse_count;
+    }
+    else if (rec->key_code && key == KEY_RESIZE)
+    {
+        PDC_resize_screen(rec->lines, rec->cols);
+        SP->resized = TRUE;
+    }
+
+    _play_read();
+
+    return key;
+}
+
+int PDC_record_input(const char *filename)
+{
+    PDC_LOG(("PDC_record_input() - called\n"));
+
+    if (rec_fp)
+    {
+        fclose(rec_fp);
+        rec_fp = NULL;
+    }
+
+    if (!filename)
+        return OK;
+
+    rec_fp = fopen(filename, "wb");
+    if (!rec_fp)
+        return ERR;
+
+    fputs(INPUT_MAGIC, rec_fp);
+    rec_mark = PDC_us_count();
+
+    return OK;
+}
+
+int PDC_play_input(const char *filename, bool fast)
+{
+    char magic[8];
+
+    PDC_LOG(("PDC_play_input() - called\n"));
+
+    if (play_fp)
+    {
+        fclose(play_fp);
+        play_fp = NULL;
+    }
+
+    if (!filename)
+        return OK;
+
+    play_fp = fopen(filename, "rb");
+    if (!play_fp)
+        return ERR;
+
+    if (fread(magic, 1, 8, play_fp) != 8 || memcmp(magic, INPUT_MAGIC, 8))
+    {
+        fclose(play_fp);
+        play_fp = NULL;
+        return ERR;
+    }
+
+    play_fast = fast;
+    play_mark = PDC_us_count();
+
+    _play_read();
+
+    return OK;
+}
+
+int PDC_post_key(int key)
+{
+    unsigned long pos;
+
+    /* no PDC_LOG() here, as the trace file isn't thread-safe */
+
+    do
+    {
+        pos = post_head;
+
+        if (pos - post_tail >= POSTQ_SIZE)
+        {
+            PDC_TRACE((PDC_EV_POST_KEY, key, ERR, 0));
+            return ERR;
+        }
+    } while (!PDC_CAS(&post_head, pos, pos + 1));
+
+    postq[pos % POSTQ_SIZE].key = key;
+    PDC_FENCE();
+    postq[pos % POSTQ_SIZE].seq = pos + 1;
+
+    PDC_wakeup();
+
+    PDC_TRACE((PDC_EV_POST_KEY, key, OK, 0));
+
+    return OK;
+}
+
 int wgetch(WINDOW *win)
 {
-    int key, waitcount;
+    int key, waitms;
+    bool found;
 
     PDC_LOG(("wgetch() - called\n"));
 
     if (!win || !SP)
         return ERR;
 
-    waitcount = 0;
-
-    /* set the number of 1/20th second napms() calls */
+    /* set the time to wait for a key, in milliseconds; -1 for no
+       limit */
 
     if (SP->delaytenths)
-        waitcount = 2 * SP->delaytenths;
+        waitms = 100 * SP->delaytenths;
+    else if (win->_delayms)
+        waitms = win->_delayms;
+    else if (win->_nodelay)
+        waitms = 0;
     else
-        if (win->_delayms)
-        {
-            /* Can't really do millisecond intervals, so delay in
-               1/20ths of a second (50ms) */
+        waitms = -1;
 
-            waitcount = win->_delayms / 50;
-            if (!waitcount)
-                waitcount = 1;
-        }
+    PDC_TRACE((PDC_EV_WGETCH, waitms, 0, 0));
 
     /* refresh window when wgetch is called if there have been changes
        to it and it is not a pad */
@@ -375,30 +802,46 @@ int wgetch(WINDOW *win)
 
     for (;;)            /* loop for any buffering */
     {
-        /* is there a keystroke ready? */
+        /* repaint for init_color(), as napms() would */
 
-        if (!PDC_check_key())
-        {
-            /* if not, handle timeout() and halfdelay() */
+        if (SP->dirty)
+            napms(0);
 
-            if (SP->delaytenths || win->_delayms)
-            {
-                if (!waitcount)
-                    return ERR;
+        /* wait for a keystroke, within timeout() or halfdelay(); the
+           time left carries over if the event is filtered out below */
 
-                waitcount--;
-            }
-            else
-                if (win->_nodelay)
-                    return ERR;
+        post_ready = FALSE;
+
+        PDC_TRACE((PDC_EV_WAIT, waitms, 0, 0));
+        found = play_fp ? _play_wait(&waitms) : PDC_wait_key(&waitms);
+        PDC_TRACE((PDC_EV_WAIT_END, waitms, found, 0));
+
+        if (!found)
+            return ERR;
 
-            napms(50);  /* sleep for 1/20th second */
-            continue;   /* then check again */
+        /* fetch it -- from the posted keys, if that's what the wait
+           found */
+
+        paste_echoed = FALSE;
+        SP->key_time = 0;
+
+        if (post_ready)
+            key = _take_posted();
+        else if (play_fp)
+            key = _play_key();
+        else
+        {
+            key = PDC_get_key();
+
+            if (rec_fp && key != -1)
+                _record(key);
         }
 
-        /* if there is, fetch it */
+        /* the platform may have stamped the key when it arrived; if
+           not, it's arriving now */
 
-        key = PDC_get_key();
+        if (!SP->key_time)
+            SP->key_time = PDC_us_count();
 
         /* copy or paste? */
 
@@ -410,14 +853,14 @@ int wgetch(WINDOW *win)
                 continue;
             }
             else if (0x16 == key)
-                key = _paste();
+                key = _paste(win);
         }
 
         /* filter mouse events; translate mouse clicks in the slk
            area to function keys */
 
         if (SP->key_code && key == KEY_MOUSE)
-            key = _mouse_key();
+            key = _mouse_key(win);
 
         /* filter special keys if not in keypad mode */
 
@@ -429,8 +872,18 @@ int wgetch(WINDOW *win)
         if (key == -1)
             continue;
 
-        _highlight();
-        SP->sel_start = SP->sel_end = -1;
+        PDC_TRACE((PDC_EV_KEY, key, SP->key_code, 0));
+
+        /* start timing until the screen shows a response, unless an
+           earlier key is still waiting for one */
+
+        if (!SP->key_pending)
+        {
+            SP->key_mark = SP->key_time;
+            SP->key_pending = TRUE;
+        }
+
+        _select(-1, -1);
 
         /* translate CR */
 
@@ -439,7 +892,7 @@ int wgetch(WINDOW *win)
 
         /* if echo is enabled */
 
-        if (SP->echo && !SP->key_code)
+        if (SP->echo && !SP->key_code && !paste_echoed)
         {
             waddch(win, key);
             wrefresh(win);
@@ -491,6 +944,7 @@ int mvwgetch(WINDOW *win, int y, int x)
 int PDC_ungetch(int ch)
 {
     PDC_LOG(("ungetch() - called\n"));
+    PDC_TRACE((PDC_EV_UNGETCH, ch, 0, 0));
 
     if (SP->c_ungind >= SP->c_ungmax)   /* pushback stack full */
         return ERR;
@@ -507,6 +961,8 @@ int flushinp(void)
     if (!SP)
         return ERR;
 
+    PDC_TRACE((PDC_EV_FLUSHINP, 0, 0, 0));
+
     PDC_flushinp();
 
     SP->c_gindex = 1;       /* set indices to kill buffer */
@@ -537,6 +993,33 @@ int PDC_return_key_modifiers(bool flag)
     return PDC_modifiers_set();
 }
 
+int PDC_set_paste_mode(bool flag)
+{
+    PDC_LOG(("PDC_set_paste_mode() - called\n"));
+
+    if (!SP)
+        return ERR;
+
+    PDC_TRACE((PDC_EV_PASTE_MODE, flag, 0, 0));
+
+    SP->paste_mode = flag;
+
+    return OK;
+}
+
+const char *PDC_get_paste_buffer(long *len)
+{
+    PDC_LOG(("PDC_get_paste_buffer() - called\n"));
+
+    if (!SP || !SP->paste_buf)
+        return NULL;
+
+    if (len)
+        *len = SP->paste_len;
+
+    return SP->paste_buf;
+}
+
 #ifdef PDC_WIDE
 int wget_wch(WINDOW *win, wint_t *wch)
 {
@@ -19,6 +19,8 @@ inch
     int mvin_wch(int y, int x, cchar_t *wcval);
     int mvwin_wch(WINDOW *win, int y, int x, cchar_t *wcval);
 
+    int winrgb(WINDOW *win, int *fg, int *bg);
+
 ### Description
 
    The inch() functions retrieve the character and attribute from the
@@ -30,6 +32,10 @@ inch
    wcval, and return OK or ERR. (No value is stored when ERR is
    returned.) Note that in PDCurses, chtype and cchar_t are the same.
 
+   winrgb() gets the direct colors of the cell at the window's cursor,
+   as set by wrgb_set(): each a PDC_RGB_COLOR() value, or -1 where the
+   cell takes that color from its pair.
+
 ### Portability
 
    Function              | X/Open | ncurses | NetBSD
@@ -42,6 +48,7 @@ inch
    win_wch               |    Y   |    Y    |   Y
    mvin_wch              |    Y   |    Y    |   Y
    mvwin_wch             |    Y   |    Y    |   Y
+   winrgb                |    -   |    -    |   -
 
 **man-end****************************************************************/
 
@@ -126,3 +133,20 @@ int mvwin_wch(WINDOW *win, int y, int x, cchar_t *wcval)
     return OK;
 }
 #endif
+
+int winrgb(WINDOW *win, int *fg, int *bg)
+{
+    PDC_SIDE *side;
+
+    PDC_LOG(("winrgb() - called\n"));
+
+    if (!win || !fg || !bg)
+        return ERR;
+
+    side = PDC_SIDE_AT(win, win->_cury, win->_curx);
+
+    *fg = (side && side->f) ? side->f : -1;
+    *bg = (side && side->b) ? side->b : -1;
+
+    return OK;
+}
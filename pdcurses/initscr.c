@@ -147,6 +147,17 @@ WINDOW *initscr(void)
     SP->visibility = 1;
     SP->resized = FALSE;
     SP->_trap_mbe = 0L;
+    SP->mouse_count = 1;
+    SP->report_mouse_count = FALSE;
+    SP->paste_mode = FALSE;
+    SP->paste_buf = NULL;
+    SP->paste_len = 0;
+    SP->trace_on = FALSE;
+    SP->replay_frames = 0;
+    SP->key_pending = FALSE;
+#ifdef PDCDEBUG
+    SP->latency_overlay = !!getenv("PDC_LATENCY");
+#endif
     SP->linesrippedoff = 0;
     SP->linesrippedoffontop = 0;
     SP->delaytenths = 0;
@@ -228,6 +239,7 @@ WINDOW *initscr(void)
     else
         curscr->_clear = TRUE;
 
+    COLOR_PAIRS = PDC_COLOR_PAIRS;
     SP->atrtab = calloc(PDC_COLOR_PAIRS, sizeof(PDC_PAIR));
     if (!SP->atrtab)
         return NULL;
@@ -257,6 +269,20 @@ WINDOW *initscr(void)
     SP->c_ungind = 0;
     SP->c_ungmax = NUNGETCH;
 
+    /* start tracing, replay timing, and the recording or playback of
+       input and the screen, now that SP is complete */
+
+    if (getenv("PDC_TRACE"))
+        PDC_trace_start(0);
+    if (getenv("PDC_REPLAY"))
+        PDC_replay_start(atoi(getenv("PDC_REPLAY")));
+    if (getenv("PDC_RECORD_INPUT"))
+        PDC_record_input(getenv("PDC_RECORD_INPUT"));
+    if (getenv("PDC_PLAY_INPUT"))
+        PDC_play_input(getenv("PDC_PLAY_INPUT"), !!getenv("PDC_PLAY_FAST"));
+    if (getenv("PDC_RECORD_SCREEN"))
+        PDC_record_screen(getenv("PDC_RECORD_SCREEN"));
+
     return stdscr;
 }
 
@@ -317,6 +343,10 @@ void delscreen(SCREEN *sp)
     free(SP->c_ungch);
     free(SP->c_buffer);
     free(SP->atrtab);
+    free(SP->batch_wins);
+
+    if (SP->paste_buf)
+        PDC_freeclipboard(SP->paste_buf);
 
     PDC_slk_free();     /* free the soft label keys, if needed */
 
@@ -327,6 +357,10 @@ void delscreen(SCREEN *sp)
     curscr = (WINDOW *)NULL;
     SP->lastscr = (WINDOW *)NULL;
 
+    free(SP->win_list);
+    free(SP->pair_map);
+    free(SP->pair_map_ok);
+
     SP->alive = FALSE;
 
     PDC_scr_free();
@@ -348,6 +382,8 @@ int resize_term(int nlines, int ncols)
     LINES = SP->lines - SP->linesrippedoff - SP->slklines;
     SP->cols = COLS = PDC_get_columns();
 
+    PDC_TRACE((PDC_EV_RESIZE, SP->lines, SP->cols, 0));
+
     if (SP->cursrow >= SP->lines)
         SP->cursrow = SP->lines - 1;
     if (SP->curscol >= SP->cols)
@@ -410,6 +446,9 @@ void PDC_get_version(PDC_VERSION *ver)
 #endif
 #ifdef PDC_RGB
         | PDC_VFLAG_RGB
+#endif
+#ifdef PDCSTATS
+        | PDC_VFLAG_STATS
 #endif
         ;
 
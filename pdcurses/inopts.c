@@ -81,10 +81,11 @@ inopts
    if zero, then non-blocking reads are done -- if no input is waiting,
    ERR is returned immediately. If the delay is positive, the read
    blocks for the delay period; if the period expires, ERR is returned.
-   The delay is given in milliseconds, but this is rounded down to 50ms
-   (1/20th sec) intervals, with a minimum of one interval if a postive
-   delay is given; i.e., 1-99 will wait 50ms, 100-149 will wait 100ms,
-   etc.
+   The delay is given in milliseconds. Where the platform can wait for
+   input with a timeout (X11, SDL2 and Windows), it's kept to within a
+   millisecond or so, and a key ends the wait as soon as it arrives;
+   elsewhere, input is checked for at intervals, of 50ms in DOS and
+   10ms otherwise.
 
    wgetdelay() returns the delay timeout as set in wtimeout().
 
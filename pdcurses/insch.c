@@ -139,7 +139,7 @@ int winsch(WINDOW *win, chtype ch)
            attributes are not there and that the background character
            will only print if the printing character is blank. */
 
-        if (!(attr & A_COLOR))
+        if (!(attr & A_COLOR) && !win->_sideattr.pair)
             attr |= win->_bkgd & A_ATTRIBUTES;
         else
             attr |= win->_bkgd & (A_ATTRIBUTES ^ A_COLOR);
@@ -156,6 +156,13 @@ int winsch(WINDOW *win, chtype ch)
 
         memmove(temp + 1, temp, (maxx - x - 1) * sizeof(chtype));
 
+        if (win->_side)
+        {
+            memmove(win->_side[y] + x + 1, win->_side[y] + x,
+                    (maxx - x - 1) * sizeof(PDC_SIDE));
+            win->_side[y][x] = win->_sideattr;
+        }
+
         win->_lastch[y] = maxx - 1;
 
         if ((win->_firstch[y] == _NO_CHANGE) || (win->_firstch[y] > x))
@@ -59,7 +59,8 @@ kernel
    the OS, all times are approximate. (In DOS, the delay is actually
    rounded down to 50ms (1/20th sec) intervals, with a minimum of one
    interval; i.e., 1-99 will wait 50ms, 100-149 will wait 100ms, etc.)
-   0 returns immediately.
+   0 returns immediately. In replay mode (see doupdate()), napms() and
+   delay_output() don't wait at all.
 
    resetterm(), fixterm() and saveterm() are archaic equivalents for
    reset_shell_mode(), reset_prog_mode() and def_prog_mode(),
@@ -234,6 +235,8 @@ int napms(int ms)
     if (!SP)
         return ERR;
 
+    PDC_TRACE((PDC_EV_NAPMS, ms, 0, 0));
+
     if (SP->dirty)
     {
         int curs_state = SP->visibility;
@@ -243,13 +246,13 @@ int napms(int ms)
 
         leaveok(curscr, TRUE);
 
-        wrefresh(curscr);
+        doupdate();
 
         leaveok(curscr, leave_state);
         curs_set(curs_state);
     }
 
-    if (ms)
+    if (ms && !SP->replay_frames)
         PDC_napms(ms);
 
     return OK;
@@ -97,7 +97,7 @@ static const char *names[] =
     "SHF_PADSTAR", "SHF_PADPLUS", "SHF_PADMINUS", "SHF_UP", "SHF_DOWN",
     "SHF_IC", "SHF_DC", "KEY_MOUSE", "KEY_SHIFT_L", "KEY_SHIFT_R",
     "KEY_CONTROL_L", "KEY_CONTROL_R", "KEY_ALT_L", "KEY_ALT_R",
-    "KEY_RESIZE", "KEY_SUP", "KEY_SDOWN"
+    "KEY_RESIZE", "KEY_SUP", "KEY_SDOWN", "KEY_PASTE"
 };
 
 char *keyname(int key)
@@ -25,6 +25,8 @@ mouse
     int ungetmouse(MEVENT *event);
     bool has_mouse(void);
 
+    int PDC_report_mouse_count(bool flag);
+
 ### Description
 
    As of PDCurses 3.0, there are two separate mouse interfaces: the
@@ -74,7 +76,12 @@ mouse
    event, and there are no more events waiting, it will wait for the
    timeout interval, then check again for a release. A press followed by
    a release is reported as BUTTON_CLICKED; otherwise it's passed
-   through as BUTTON_PRESSED. The default timeout is 150ms; valid values
+   through as BUTTON_PRESSED. In x11 and sdl2, the wait doesn't block:
+   getch() holds the press back, without stalling on it, until its
+   release arrives, other input does, or the time runs out. There,
+   a second click whose press comes within the timeout of the first
+   one's release is reported as BUTTON_DOUBLE_CLICKED, if that's in the
+   mouse mask. The default timeout is 150ms; valid values
    are 0 (no clicks reported) through 1000ms. In x11, the timeout can
    also be set via the clickPeriod resource. The return value from
    mouseinterval() is the old timeout. To check the old value without
@@ -117,24 +124,33 @@ mouse
    has_mouse() reports whether the mouse is available at all on the
    current platform.
 
+   In x11 and sdl2, mouse motion and wheel events that queue up back to
+   back are merged into one KEY_MOUSE: motion with the same buttons
+   held reports only the latest position, and wheel steps in the same
+   direction are added up. PDC_report_mouse_count() tells nc_getmouse()
+   to put the number of device events behind the mouse event -- moves
+   or wheel steps -- in the MEVENT's z field, instead of 0. It's always
+   at least 1, and is 1 on platforms that don't merge events.
+
 ### Portability
 
-   Function              | X/Open | ncurses | NetBSD
-   :---------------------|:------:|:-------:|:------:
-   mouse_set             |    -   |    -    |   -
-   mouse_on              |    -   |    -    |   -
-   mouse_off             |    -   |    -    |   -
-   request_mouse_pos     |    -   |    -    |   -
-   wmouse_position       |    -   |    -    |   -
-   getmouse              |    -   |    *    |   -
-   mouseinterval         |    -   |    Y    |   -
-   wenclose              |    -   |    Y    |   -
-   wmouse_trafo          |    -   |    Y    |   -
-   mouse_trafo           |    -   |    Y    |   -
-   mousemask             |    -   |    Y    |   -
-   nc_getmouse           |    -   |    *    |   -
-   ungetmouse            |    -   |    Y    |   -
-   has_mouse             |    -   |    Y    |   -
+   Function               | X/Open | ncurses | NetBSD
+   :----------------------|:------:|:-------:|:------:
+   mouse_set              |    -   |    -    |   -
+   mouse_on               |    -   |    -    |   -
+   mouse_off              |    -   |    -    |   -
+   request_mouse_pos      |    -   |    -    |   -
+   wmouse_position        |    -   |    -    |   -
+   getmouse               |    -   |    *    |   -
+   mouseinterval          |    -   |    Y    |   -
+   wenclose               |    -   |    Y    |   -
+   wmouse_trafo           |    -   |    Y    |   -
+   mouse_trafo            |    -   |    Y    |   -
+   mousemask              |    -   |    Y    |   -
+   nc_getmouse            |    -   |    *    |   -
+   ungetmouse             |    -   |    Y    |   -
+   has_mouse              |    -   |    Y    |   -
+   PDC_report_mouse_count |    -   |    -    |   -
 
    \* See above, under Description
 
@@ -322,7 +338,7 @@ int nc_getmouse(MEVENT *event)
 
     event->x = Mouse_status.x;
     event->y = Mouse_status.y;
-    event->z = 0;
+    event->z = SP->report_mouse_count ? SP->mouse_count : 0;
 
     for (i = 0; i < 3; i++)
     {
@@ -375,6 +391,7 @@ int ungetmouse(MEVENT *event)
 
     ungot = TRUE;
 
+    SP->mouse_count = 1;
     SP->mouse_status.x = event->x;
     SP->mouse_status.y = event->y;
 
@@ -421,3 +438,15 @@ bool has_mouse(void)
 {
     return PDC_has_mouse();
 }
+
+int PDC_report_mouse_count(bool flag)
+{
+    PDC_LOG(("PDC_report_mouse_count() - called\n"));
+
+    if (!SP)
+        return ERR;
+
+    SP->report_mouse_count = flag;
+
+    return OK;
+}
@@ -57,6 +57,7 @@ static int _copy_win(const WINDOW *src_w, WINDOW *dst_w, int src_tr,
 {
     int col, line, y1, fc, *minchng, *maxchng;
     chtype *w1ptr, *w2ptr;
+    PDC_SIDE none = {0}, *s1ptr, *s2ptr;
 
     int lc = 0;
     int xdiff = src_bc - src_tc;
@@ -79,15 +80,25 @@ static int _copy_win(const WINDOW *src_w, WINDOW *dst_w, int src_tr,
         w1ptr = src_w->_y[line + src_tr] + src_tc;
         w2ptr = dst_w->_y[line + dst_tr] + dst_tc;
 
+        /* side cells go with the cells; a source without a plane
+           has none to give */
+
+        s1ptr = src_w->_side ? src_w->_side[line + src_tr] + src_tc : &none;
+        s2ptr = dst_w->_side ? dst_w->_side[line + dst_tr] + dst_tc : NULL;
+
         fc = _NO_CHANGE;
 
         for (col = 0; col < xdiff; col++)
         {
-            if ((*w1ptr) != (*w2ptr) &&
+            if (((*w1ptr) != (*w2ptr) ||
+                 (s2ptr && !PDC_SIDE_SAME(*s1ptr, s2ptr[col]))) &&
                 !((*w1ptr & A_CHARTEXT) == ' ' && _overlay))
             {
                 *w2ptr = *w1ptr;
 
+                if (s2ptr)
+                    s2ptr[col] = *s1ptr;
+
                 if (fc == _NO_CHANGE)
                     fc = col + dst_tc;
 
@@ -96,6 +107,9 @@ static int _copy_win(const WINDOW *src_w, WINDOW *dst_w, int src_tr,
 
             w1ptr++;
             w2ptr++;
+
+            if (s1ptr != &none)
+                s1ptr++;
         }
 
         if (*minchng == _NO_CHANGE)
@@ -75,6 +75,7 @@ pad
 
 **man-end****************************************************************/
 
+#include <stdlib.h>
 #include <string.h>
 
 WINDOW *newpad(int nlines, int ncols)
@@ -151,6 +152,22 @@ WINDOW *subpad(WINDOW *orig, int nlines, int ncols, int begy, int begx)
     win->_pad._pad_bottom = min(LINES, nlines) - 1;
     win->_pad._pad_right = min(COLS, ncols) - 1;
 
+    /* share the parent's side plane, as with the lines */
+
+    if (orig->_side)
+    {
+        win->_sideattr = orig->_sideattr;
+        win->_side = malloc(nlines * sizeof(PDC_SIDE *));
+        if (!win->_side)
+        {
+            delwin(win);
+            return (WINDOW *)NULL;
+        }
+
+        for (i = 0; i < nlines; i++)
+            win->_side[i] = orig->_side[begy + i] + begx;
+    }
+
     return win;
 }
 
@@ -187,6 +204,8 @@ int pnoutrefresh(WINDOW *w, int py, int px, int sy1, int sx1, int sy2, int sx2)
         (sy2 < sy1) || (sx2 < sx1))
         return ERR;
 
+    PDC_expand_touch(w);
+
     sline = sy1;
     pline = py;
 
@@ -199,6 +218,10 @@ int pnoutrefresh(WINDOW *w, int py, int px, int sy1, int sx1, int sy2, int sx2)
             memcpy(curscr->_y[sline] + sx1, w->_y[pline] + px,
                    num_cols * sizeof(chtype));
 
+            if (w->_side && curscr->_side)
+                memcpy(curscr->_side[sline] + sx1, w->_side[pline] + px,
+                       num_cols * sizeof(PDC_SIDE));
+
             if ((curscr->_firstch[sline] == _NO_CHANGE)
                 || (curscr->_firstch[sline] > sx1))
                 curscr->_firstch[sline] = sx1;
@@ -16,6 +16,7 @@ panel
     PANEL *new_panel(WINDOW *win);
     PANEL *panel_above(const PANEL *pan);
     PANEL *panel_below(const PANEL *pan);
+    int panel_move_above(PANEL *pan, PANEL *ref);
     int panel_hidden(const PANEL *pan);
     const void *panel_userptr(const PANEL *pan);
     WINDOW *panel_window(const PANEL *pan);
@@ -64,6 +65,10 @@ panel
    or NULL if pan is the bottom panel. If the value of pan passed is
    NULL, this function returns a pointer to the top panel in the deck.
 
+   panel_move_above() places pan in the deck directly above ref, or at
+   the bottom of the deck if ref is NULL. If pan is hidden, this shows
+   it. ref must be in the deck, and must not be pan.
+
    panel_hidden() returns OK if pan is hidden and ERR if it is not.
 
    panel_userptr() - Each panel has a user pointer available for
@@ -106,6 +111,7 @@ panel
    new_panel             |    -   |    Y    |   Y
    panel_above           |    -   |    Y    |   Y
    panel_below           |    -   |    Y    |   Y
+   panel_move_above      |    -   |    -    |   -
    panel_hidden          |    -   |    Y    |   Y
    panel_userptr         |    -   |    Y    |   Y
    panel_window          |    -   |    Y    |   Y
@@ -122,6 +128,7 @@ panel
 **man-end****************************************************************/
 
 #include <panel.h>
+#include <limits.h>
 #include <stdlib.h>
 
 PANEL *_bottom_panel = (PANEL *)0;
@@ -202,6 +209,57 @@ static bool _panels_overlapped(PANEL *pan1, PANEL *pan2)
          || (pan2->wstartx >= pan1->wstartx && pan2->wstartx < pan1->wendx));
 }
 
+/* The overlap ("obscure") list of each panel in the deck holds every
+   panel in the deck that overlaps it, itself included, ordered from
+   bottom to top by zorder. The lists are updated incrementally, only
+   for the panel being linked, unlinked or moved. Candidate neighbors
+   come from a uniform grid of screen buckets, each listing the panels
+   that cover it. List and bucket nodes are both PANELOBS, taken from
+   a free pool that grows in blocks and is never returned. */
+
+#define PANEL_GRID_H    4       /* bucket height, in lines */
+#define PANEL_GRID_W    16      /* bucket width, in columns */
+#define PANEL_POOL      64      /* nodes per pool block */
+
+static PANELOBS *_obs_pool = (PANELOBS *)0;
+static PANELOBS **_grid = (PANELOBS **)0;
+static int _grid_rows = 0;
+static int _grid_cols = 0;
+
+static PANELOBS *_obs_alloc(PANEL *pan)
+{
+    PANELOBS *obs;
+
+    if (!_obs_pool)
+    {
+        int i;
+
+        obs = malloc(PANEL_POOL * sizeof(PANELOBS));
+        if (!obs)
+            return (PANELOBS *)0;
+
+        for (i = 0; i < PANEL_POOL; i++)
+        {
+            obs[i].above = _obs_pool;
+            _obs_pool = obs + i;
+        }
+    }
+
+    obs = _obs_pool;
+    _obs_pool = obs->above;
+
+    obs->above = (PANELOBS *)0;
+    obs->pan = pan;
+
+    return obs;
+}
+
+static void _obs_release(PANELOBS *obs)
+{
+    obs->above = _obs_pool;
+    _obs_pool = obs;
+}
+
 static void _free_obscure(PANEL *pan)
 {
     PANELOBS *tobs = pan->obscure;  /* "this" one */
@@ -210,12 +268,199 @@ static void _free_obscure(PANEL *pan)
     while (tobs)
     {
         nobs = tobs->above;
-        free((char *)tobs);
+        _obs_release(tobs);
         tobs = nobs;
     }
     pan->obscure = (PANELOBS *)0;
 }
 
+/* insert pan2 into pan's obscure list, keeping it in z-order */
+
+static void _obs_insert(PANEL *pan, PANEL *pan2)
+{
+    PANELOBS **link = &(pan->obscure);
+    PANELOBS *tobs;
+
+    while (*link && (*link)->pan->zorder < pan2->zorder)
+        link = &((*link)->above);
+
+    if ((tobs = _obs_alloc(pan2)) == NULL)
+        return;
+
+    tobs->above = *link;
+    *link = tobs;
+}
+
+/* unlink and release the node for pan2 from a list */
+
+static void _obs_remove(PANELOBS **link, PANEL *pan2)
+{
+    while (*link)
+    {
+        PANELOBS *tobs = *link;
+
+        if (tobs->pan == pan2)
+        {
+            *link = tobs->above;
+            _obs_release(tobs);
+            return;
+        }
+
+        link = &(tobs->above);
+    }
+}
+
+/* range of grid buckets covered by pan; parts of a panel outside the
+   screen fall into the edge buckets */
+
+static int _grid_clamp(int i, int n)
+{
+    return (i < 0) ? 0 : (i >= n) ? n - 1 : i;
+}
+
+static void _grid_span(const PANEL *pan, int *r0, int *r1, int *c0, int *c1)
+{
+    *r0 = _grid_clamp(pan->wstarty / PANEL_GRID_H, _grid_rows);
+    *r1 = _grid_clamp((pan->wendy - 1) / PANEL_GRID_H, _grid_rows);
+    *c0 = _grid_clamp(pan->wstartx / PANEL_GRID_W, _grid_cols);
+    *c1 = _grid_clamp((pan->wendx - 1) / PANEL_GRID_W, _grid_cols);
+}
+
+static void _grid_insert(PANEL *pan)
+{
+    int r, c, r0, r1, c0, c1;
+
+    _grid_span(pan, &r0, &r1, &c0, &c1);
+
+    for (r = r0; r <= r1; r++)
+        for (c = c0; c <= c1; c++)
+        {
+            PANELOBS **bucket = _grid + r * _grid_cols + c;
+            PANELOBS *tobs = _obs_alloc(pan);
+
+            if (!tobs)
+                return;
+
+            tobs->above = *bucket;
+            *bucket = tobs;
+        }
+}
+
+static void _grid_remove(PANEL *pan)
+{
+    int r, c, r0, r1, c0, c1;
+
+    if (!_grid)
+        return;
+
+    _grid_span(pan, &r0, &r1, &c0, &c1);
+
+    for (r = r0; r <= r1; r++)
+        for (c = c0; c <= c1; c++)
+            _obs_remove(_grid + r * _grid_cols + c, pan);
+}
+
+/* (re)build the grid if the screen size has changed; only panels that
+   already have their obscure list are put back */
+
+static bool _grid_sync(void)
+{
+    int i, rows, cols;
+    PANEL *pan;
+
+    rows = (LINES + PANEL_GRID_H - 1) / PANEL_GRID_H;
+    cols = (COLS + PANEL_GRID_W - 1) / PANEL_GRID_W;
+
+    if (rows < 1)
+        rows = 1;
+    if (cols < 1)
+        cols = 1;
+
+    if (_grid && rows == _grid_rows && cols == _grid_cols)
+        return TRUE;
+
+    if (_grid)
+    {
+        for (i = 0; i < _grid_rows * _grid_cols; i++)
+            while (_grid[i])
+                _obs_remove(_grid + i, _grid[i]->pan);
+
+        free(_grid);
+    }
+
+    _grid = calloc(rows * cols, sizeof(PANELOBS *));
+    if (!_grid)
+    {
+        _grid_rows = _grid_cols = 0;
+        return FALSE;
+    }
+
+    _grid_rows = rows;
+    _grid_cols = cols;
+
+    for (pan = _bottom_panel; pan; pan = pan->above)
+        if (pan->obscure)
+            _grid_insert(pan);
+
+    return TRUE;
+}
+
+/* add pan's edges to the overlap graph; pan must be in the stack */
+
+static void _obscure_add(PANEL *pan)
+{
+    int r, c, r0, r1, c0, c1;
+
+    if (!_grid_sync())
+        return;
+
+    _obs_insert(pan, pan);
+
+    _grid_span(pan, &r0, &r1, &c0, &c1);
+
+    for (r = r0; r <= r1; r++)
+        for (c = c0; c <= c1; c++)
+        {
+            PANELOBS *tobs = _grid[r * _grid_cols + c];
+
+            for (; tobs; tobs = tobs->above)
+            {
+                PANEL *pan2 = tobs->pan;
+                int s0, s1, t0, t1;
+
+                if (!_panels_overlapped(pan, pan2))
+                    continue;
+
+                /* take each pair only in the first bucket they share */
+
+                _grid_span(pan2, &s0, &s1, &t0, &t1);
+
+                if (r != max(r0, s0) || c != max(c0, t0))
+                    continue;
+
+                dPanel("obscured", pan2);
+                _obs_insert(pan, pan2);
+                _obs_insert(pan2, pan);
+            }
+        }
+
+    _grid_insert(pan);
+}
+
+/* remove pan's edges from the overlap graph */
+
+static void _obscure_remove(PANEL *pan)
+{
+    PANELOBS *tobs;
+
+    for (tobs = pan->obscure; tobs; tobs = tobs->above)
+        if (tobs->pan != pan)
+            _obs_remove(&(tobs->pan->obscure), pan);
+
+    _free_obscure(pan);
+    _grid_remove(pan);
+}
+
 static void _pairwise_override(PANEL *pan, PANEL *pan2)
 {
     const int sy1 = pan->wstarty, sy2 = pan2->wstarty;
@@ -256,159 +501,196 @@ static void _override(PANEL *pan, int show)
     _pairwise_override(&_stdscr_pseudo_panel, pan);
 }
 
-static void _calculate_obscure(void)
+/* zorder values are spaced PANEL_ZGAP apart, so that a panel can be
+   placed between two others without renumbering the deck */
+
+#define PANEL_ZGAP      1024L
+
+/* touch the part of pan's window inside the screen rectangle from
+   (y0, x0) up to, but not including, (y1, x1) */
+
+static void _touch_rect(PANEL *pan, int y0, int y1, int x0, int x1)
 {
-    PANEL *pan, *pan2;
-    PANELOBS *tobs;     /* "this" one */
-    PANELOBS *lobs;     /* last one */
+    WINDOW *win = pan->win;
+    int y;
 
-    pan = _bottom_panel;
+    y0 = max(y0, pan->wstarty) - pan->wstarty;
+    y1 = min(min(y1, pan->wendy) - pan->wstarty, win->_maxy);
+    x0 = max(x0, pan->wstartx) - pan->wstartx;
+    x1 = min(min(x1, pan->wendx) - pan->wstartx, win->_maxx) - 1;
 
-    while (pan)
+    if (x0 > x1)
+        return;
+
+    for (y = y0; y < y1; y++)
     {
-        if (pan->obscure)
-            _free_obscure(pan);
+        if (win->_firstch[y] == _NO_CHANGE || win->_firstch[y] > x0)
+            win->_firstch[y] = x0;
 
-        lobs = (PANELOBS *)0;
-        pan2 = _bottom_panel;
+        if (win->_lastch[y] < x1)
+            win->_lastch[y] = x1;
+    }
+}
 
-        while (pan2)
-        {
-            if (_panels_overlapped(pan, pan2))
-            {
-                if ((tobs = malloc(sizeof(PANELOBS))) == NULL)
-                    return;
+/* touch the given screen rectangle in stdscr and in the panels below
+   pan, which show through there once pan has moved away */
 
-                tobs->pan = pan2;
-                dPanel("obscured", pan2);
-                tobs->above = (PANELOBS *)0;
+static void _expose(PANEL *pan, int y0, int y1, int x0, int x1)
+{
+    PANELOBS *tobs;
 
-                if (lobs)
-                    lobs->above = tobs;
-                else
-                    pan->obscure = tobs;
+    if (y0 >= y1 || x0 >= x1)
+        return;
 
-                lobs  = tobs;
-            }
+    _touch_rect(&_stdscr_pseudo_panel, y0, y1, x0, x1);
 
-            pan2 = pan2->above;
-        }
+    for (tobs = pan->obscure; tobs && tobs->pan != pan; tobs = tobs->above)
+        _touch_rect(tobs->pan, y0, y1, x0, x1);
+}
 
-        _override(pan, 1);
-        pan = pan->above;
-    }
+/* give the deck evenly spaced zorder values again; relative order is
+   unchanged */
+
+static void _renumber(void)
+{
+    PANEL *pan;
+    long z = 0;
+
+    for (pan = _bottom_panel; pan; pan = pan->above, z += PANEL_ZGAP)
+        pan->zorder = z;
 }
 
-/* check to see if panel is in the stack */
+/* zorder for a panel going directly above ref (NULL for the bottom) */
 
-static bool _panel_is_linked(const PANEL *pan)
+static long _zorder_above(const PANEL *ref)
 {
-    PANEL *pan2 = _bottom_panel;
+    if (!ref)
+    {
+        if (!_bottom_panel)
+            return 0;
 
-    while (pan2)
+        if (_bottom_panel->zorder < LONG_MIN + PANEL_ZGAP)
+            _renumber();
+
+        return _bottom_panel->zorder - PANEL_ZGAP;
+    }
+
+    if (!ref->above)
     {
-        if (pan2 == pan)
-            return TRUE;
+        if (ref->zorder > LONG_MAX - PANEL_ZGAP)
+            _renumber();
 
-        pan2 = pan2->above;
+        return ref->zorder + PANEL_ZGAP;
     }
 
-    return FALSE;
+    if (ref->above->zorder - ref->zorder < 2)
+        _renumber();
+
+    return ref->zorder + (ref->above->zorder - ref->zorder) / 2;
 }
 
-/* link panel into stack at top */
+/* check to see if panel is in the stack */
 
-static void _panel_link_top(PANEL *pan)
+static bool _panel_is_linked(const PANEL *pan)
 {
-#ifdef PANEL_DEBUG
-    dStack("<lt%d>", 1, pan);
-    if (_panel_is_linked(pan))
-        return;
-#endif
-    pan->above = (PANEL *)0;
-    pan->below = (PANEL *)0;
+    return pan->linked;
+}
 
-    if (_top_panel)
-    {
-        _top_panel->above = pan;
-        pan->below = _top_panel;
-    }
+/* put pan into the stack directly above ref, or at the bottom if ref
+   is NULL */
 
-    _top_panel = pan;
+static void _stack_insert(PANEL *pan, PANEL *ref)
+{
+    pan->zorder = _zorder_above(ref);
+
+    pan->below = ref;
+    pan->above = ref ? ref->above : _bottom_panel;
+
+    if (pan->above)
+        pan->above->below = pan;
+    else
+        _top_panel = pan;
 
-    if (!_bottom_panel)
+    if (ref)
+        ref->above = pan;
+    else
         _bottom_panel = pan;
 
-    _calculate_obscure();
-    dStack("<lt%d>", 9, pan);
+    pan->linked = TRUE;
+}
+
+static void _stack_remove(PANEL *pan)
+{
+    PANEL *prev = pan->below;
+    PANEL *next = pan->above;
+
+    if (prev)
+        prev->above = next;
+    else
+        _bottom_panel = next;
+
+    if (next)
+        next->below = prev;
+    else
+        _top_panel = prev;
+
+    pan->above = (PANEL *)0;
+    pan->below = (PANEL *)0;
+    pan->linked = FALSE;
 }
 
-/* link panel into stack at bottom */
+/* link panel into stack above ref, or at the bottom if ref is NULL */
 
-static void _panel_link_bottom(PANEL *pan)
+static void _panel_link(PANEL *pan, PANEL *ref)
 {
 #ifdef PANEL_DEBUG
-    dStack("<lb%d>", 1, pan);
+    dStack("<l%d>", 1, pan);
     if (_panel_is_linked(pan))
         return;
 #endif
-    pan->above = (PANEL *)0;
-    pan->below = (PANEL *)0;
+    _stack_insert(pan, ref);
+    _obscure_add(pan);
+    _override(pan, 1);
+    dStack("<l%d>", 9, pan);
+}
 
-    if (_bottom_panel)
-    {
-        _bottom_panel->below = pan;
-        pan->above = _bottom_panel;
-    }
+/* move a linked panel to just above ref, or to the bottom if ref is
+   NULL; its overlaps don't change, only their order */
 
-    _bottom_panel = pan;
+static void _panel_restack(PANEL *pan, PANEL *ref)
+{
+    PANELOBS *tobs;
 
-    if (!_top_panel)
-        _top_panel = pan;
+    dStack("<r%d>", 1, pan);
+
+    _stack_remove(pan);
+    _stack_insert(pan, ref);
 
-    _calculate_obscure();
-    dStack("<lb%d>", 9, pan);
+    for (tobs = pan->obscure; tobs; tobs = tobs->above)
+        if (tobs->pan != pan)
+        {
+            _obs_remove(&(tobs->pan->obscure), pan);
+            _obs_insert(tobs->pan, pan);
+        }
+
+    _obs_remove(&(pan->obscure), pan);
+    _obs_insert(pan, pan);
+
+    _override(pan, 1);
+    dStack("<r%d>", 9, pan);
 }
 
 static void _panel_unlink(PANEL *pan)
 {
-    PANEL *prev;
-    PANEL *next;
-
 #ifdef PANEL_DEBUG
     dStack("<u%d>", 1, pan);
     if (!_panel_is_linked(pan))
         return;
 #endif
     _override(pan, 0);
-    _free_obscure(pan);
-
-    prev = pan->below;
-    next = pan->above;
-
-    /* if non-zero, we will not update the list head */
-
-    if (prev)
-    {
-        prev->above = next;
-        if(next)
-            next->below = prev;
-    }
-    else if (next)
-        next->below = prev;
-
-    if (pan == _bottom_panel)
-        _bottom_panel = next;
-
-    if (pan == _top_panel)
-        _top_panel = prev;
-
-    _calculate_obscure();
-
-    pan->above = (PANEL *)0;
-    pan->below = (PANEL *)0;
+    _obscure_remove(pan);
+    _stack_remove(pan);
     dStack("<u%d>", 9, pan);
-
 }
 
 /************************************************************************
@@ -424,9 +706,9 @@ int bottom_panel(PANEL *pan)
         return OK;
 
     if (_panel_is_linked(pan))
-        hide_panel(pan);
-
-    _panel_link_bottom(pan);
+        _panel_restack(pan, (PANEL *)0);
+    else
+        _panel_link(pan, (PANEL *)0);
 
     return OK;
 }
@@ -466,25 +748,54 @@ int move_panel(PANEL *pan, int starty, int startx)
 {
     WINDOW *win;
     int maxy, maxx;
+    bool linked;
 
     if (!pan)
         return ERR;
 
-    if (_panel_is_linked(pan))
-        _override(pan, 0);
-
     win = pan->win;
 
     if (mvwin(win, starty, startx) == ERR)
         return ERR;
 
-    getbegyx(win, pan->wstarty, pan->wstartx);
     getmaxyx(win, maxy, maxx);
-    pan->wendy = pan->wstarty + maxy;
-    pan->wendx = pan->wstartx + maxx;
 
-    if (_panel_is_linked(pan))
-        _calculate_obscure();
+    /* pan's recorded position is still the old one here */
+
+    linked = _panel_is_linked(pan);
+
+    if (linked)
+    {
+        int oy0 = pan->wstarty, oy1 = pan->wendy;
+        int ox0 = pan->wstartx, ox1 = pan->wendx;
+        int ny0 = starty, ny1 = starty + maxy;
+        int nx0 = startx, nx1 = startx + maxx;
+        int my0 = max(oy0, ny0), my1 = min(oy1, ny1);
+
+        /* uncover the old rectangle minus the new one: strips above,
+           below, left and right of the overlap */
+
+        _expose(pan, oy0, min(oy1, ny0), ox0, ox1);
+        _expose(pan, max(oy0, ny1), oy1, ox0, ox1);
+        _expose(pan, my0, my1, ox0, min(ox1, nx0));
+        _expose(pan, my0, my1, max(ox0, nx1), ox1);
+
+        if (oy0 != ny0 || ox0 != nx0)
+            PDC_move_hint(oy0, ox0, oy1 - oy0, ox1 - ox0, ny0, nx0);
+
+        _obscure_remove(pan);
+    }
+
+    pan->wstarty = starty;
+    pan->wstartx = startx;
+    pan->wendy = starty + maxy;
+    pan->wendx = startx + maxx;
+
+    if (linked)
+    {
+        _obscure_add(pan);
+        Touchpan(pan);
+    }
 
     return OK;
 }
@@ -526,6 +837,8 @@ PANEL *new_panel(WINDOW *win)
         pan->user = (char *)0;
 #endif
         pan->obscure = (PANELOBS *)0;
+        pan->zorder = 0;
+        pan->linked = FALSE;
         show_panel(pan);
     }
 
@@ -542,6 +855,22 @@ PANEL *panel_below(const PANEL *pan)
     return pan ? pan->below : _top_panel;
 }
 
+int panel_move_above(PANEL *pan, PANEL *ref)
+{
+    if (!pan || pan == ref || (ref && !_panel_is_linked(ref)))
+        return ERR;
+
+    if (_panel_is_linked(pan))
+    {
+        if (pan->below != ref)
+            _panel_restack(pan, ref);
+    }
+    else
+        _panel_link(pan, ref);
+
+    return OK;
+}
+
 int panel_hidden(const PANEL *pan)
 {
     if (!pan)
@@ -568,12 +897,18 @@ WINDOW *panel_window(const PANEL *pan)
 int replace_panel(PANEL *pan, WINDOW *win)
 {
     int maxy, maxx;
+    bool linked;
 
     if (!pan)
         return ERR;
 
-    if (_panel_is_linked(pan))
+    linked = _panel_is_linked(pan);
+
+    if (linked)
+    {
         _override(pan, 0);
+        _obscure_remove(pan);
+    }
 
     pan->win = win;
     getbegyx(win, pan->wstarty, pan->wstartx);
@@ -581,8 +916,11 @@ int replace_panel(PANEL *pan, WINDOW *win)
     pan->wendy = pan->wstarty + maxy;
     pan->wendx = pan->wstartx + maxx;
 
-    if (_panel_is_linked(pan))
-        _calculate_obscure();
+    if (linked)
+    {
+        _obscure_add(pan);
+        _override(pan, 1);
+    }
 
     return OK;
 }
@@ -605,9 +943,9 @@ int show_panel(PANEL *pan)
         return OK;
 
     if (_panel_is_linked(pan))
-        hide_panel(pan);
-
-    _panel_link_top(pan);
+        _panel_restack(pan, _top_panel);
+    else
+        _panel_link(pan, _top_panel);
 
     return OK;
 }
@@ -16,6 +16,12 @@ refresh
     int redrawwin(WINDOW *win);
     int wredrawln(WINDOW *win, int beg_line, int num_lines);
 
+    void PDC_move_hint(int y, int x, int nlines, int ncols,
+                       int toy, int tox);
+    int PDC_get_stats(PDC_STATS *stats, bool reset);
+    int PDC_get_latency(PDC_LATENCY *latency, bool reset);
+    int PDC_record_screen(const char *filename);
+
 ### Description
 
    wrefresh() copies the named window to the physical terminal screen,
@@ -40,9 +46,73 @@ refresh
    is the same as touchline(). In some other curses implementations,
    there's a subtle distinction, but it has no meaning in PDCurses.
 
+   PDC_move_hint() tells the next doupdate() that the nlines by ncols
+   block of the screen at (y, x) has moved to (toy, tox), as when a
+   panel is moved. If the platform can copy screen areas, doupdate()
+   moves the block on the physical screen first, and then redraws only
+   the cells that still differ. A second hint for a different block
+   before doupdate() cancels the first.
+
+   PDC_get_stats() copies the rendering counters into *stats, and, if
+   reset is TRUE, zeroes them. They count the lines and cells examined
+   by wnoutrefresh() and doupdate(), the runs and cells doupdate()
+   passes to the platform, the platform's packets (runs of cells with
+   one attribute) and blits (blocks moved by PDC_move_hint()), the
+   updates it shows, and the bytes of cells copied. They also total the
+   microseconds doupdate() spends finding the changed lines, drawing
+   them, and showing them. The clock is read once per phase, and twice
+   per changed line; drawing a line includes finding its runs. Where
+   the platform has only a millisecond clock, the times go in steps of
+   1000. The counters are kept only if the library is built with
+   PDCSTATS defined (STATS=Y, for the headless, sdl1, sdl2 and wincon
+   makefiles; --enable-stats, for x11's configure); without it, they
+   cost nothing.
+
+   PDC_get_latency() copies the input latency histogram into *latency,
+   and, if reset is TRUE, clears it. wgetch() notes when each key it
+   returns arrived -- as stamped by the platform, where it can (X11 and
+   SDL2 do), or else when it was read -- and the next doupdate() that
+   shows anything (draws cells, moves a block, or moves the visible
+   cursor) records the time from there to its completion. Keys that
+   arrive before that update are counted once, from the first. The
+   histogram has a count, total and maximum, and buckets on a
+   logarithmic scale; see PDC_LATENCY in curses.h. In a debug build
+   (PDCDEBUG), setting the environment variable PDC_LATENCY before
+   initscr() also shows the count, mean and maximum in the bottom right
+   corner of the screen, after each update.
+
+   PDC_record_screen() records each update that follows to the named
+   file, until it's called with NULL: just the runs of cells doupdate()
+   draws, with their side cells (extended pairs and direct colors),
+   the block moves from PDC_move_hint(), changes of size, the
+   definitions of the color pairs shown, and the time, in a compact
+   binary form (see refresh.c). The next update redraws the whole
+   screen, to start the recording. It costs little more than the
+   drawing does, so it may be left on; and the file compresses well,
+   with gzip, for keeping. The scrplay program (demos/scrplay.c) plays a
+   recording back through curses, or prints it as text. Changes made
+   with init_color() aren't recorded. If the environment variable
+   PDC_RECORD_SCREEN is set when initscr() is called, recording to the
+   file it names starts then.
+
+   If the environment variable PDC_REPLAY is set to a number when
+   initscr() is called, the program runs in replay mode, for timing:
+   napms() returns at once, and doupdate() records the time since the
+   previous update, in microseconds. After that many updates, the timing
+   stops, and a "q" is posted, as with PDC_post_key(), for the next
+   wgetch() to return; the demos quit on it. The program itself isn't
+   stopped. At exit, the count of frames timed, and the median, 99th
+   percentile and maximum of their times, are written to stderr. (The
+   demos that use rand() also seed it with a constant when PDC_REPLAY
+   is set, so that each run draws the same frames.)
+
 ### Return Value
 
    All functions return OK on success and ERR on error.
+   PDC_get_stats() returns ERR if the library wasn't built to keep the
+   counters.
+   PDC_get_latency() returns ERR if latency is NULL.
+   PDC_record_screen() returns ERR if the file can't be opened.
 
 ### Portability
 
@@ -54,20 +124,587 @@ refresh
    doupdate              |    Y   |    Y    |   Y
    redrawwin             |    Y   |    Y    |   Y
    wredrawln             |    Y   |    Y    |   Y
+   PDC_get_stats         |    -   |    -    |   -
+   PDC_get_latency       |    -   |    -    |   -
+   PDC_record_screen     |    -   |    -    |   -
 
 **man-end****************************************************************/
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+static struct
+{
+    bool pending;
+    int y, x, nlines, ncols, toy, tox;
+} _move;
+
+/* A line's pair map has a bit for each pair that fits in a chtype,
+   and one more byte that's set if the line has cells in extended
+   pairs, which are too many to map per line */
+
+#define _MAPSIZE (PDC_COLOR_PAIRS / 8)
+#define _MAPLINE (_MAPSIZE + 1)
+
+static unsigned char _pairs_changed[(PDC_EXT_PAIRS + 7) / 8];
+static bool _pairs_pending = FALSE;
+static bool _ext_pending = FALSE;
+
+/* Screen recording, for PDC_record_screen(). After an 8-byte header,
+   the size of a chtype, and the lines and columns, each update that
+   changed anything is a frame: the microseconds since the frame before;
+   flags (1: a new size follows, 2: a block move, 4: color pairs); the
+   lines and columns, if resized; the y, x, lines, columns, and new y
+   and x of the block, if moved; the number of pairs, and each pair's
+   number, foreground and background, if any; then the number of runs,
+   and for each, the lines down from the run before (or from the top),
+   the column, the length times two, plus one if side cells follow, and
+   the cells. Each cell is stored XORed with the one before it in the
+   run, so that a run in one attribute comes down to its text. The side
+   cells, if any, are the pair, foreground and background of each, in
+   turn XORed with those of the cell before. Numbers are varints, as in
+   PDC_record_input(), and colors are zigzag-encoded, as they may be -1.
+
+   A pair is recorded with the first frame that draws it, and again
+   after PDC_pair_changed(), so the pairs in a recording are just those
+   it shows, extended or not. */
+
+#define SCREEN_MAGIC "PDCSCRN1"
+
+static FILE *scr_fp = NULL;
+static unsigned char *scr_buf = NULL;   /* this frame's runs so far */
+static long scr_len = 0, scr_max = 0;
+static int scr_runs = 0, scr_row = 0;
+static int scr_flags = 0;
+static int scr_move[6];
+static int scr_lines, scr_cols;         /* size as last recorded */
+static unsigned char scr_known[(PDC_EXT_PAIRS + 7) / 8];  /* recorded */
+static unsigned char scr_pairs[(PDC_EXT_PAIRS + 7) / 8];  /* to record */
+static int scr_npairs = 0;              /* how many */
+static unsigned long scr_mark;          /* time of the last frame */
+
+static void _scr_put(unsigned long n)
+{
+    while (n > 0x7f)
+    {
+        putc((int)(n & 0x7f) | 0x80, scr_fp);
+        n >>= 7;
+    }
+
+    putc((int)n, scr_fp);
+}
+
+static void _scr_put_int(long n)
+{
+    _scr_put(n < 0 ? ((unsigned long)~n << 1) | 1 : (unsigned long)n << 1);
+}
+
+static unsigned char *_scr_num(unsigned char *p, unsigned long n)
+{
+    while (n > 0x7f)
+    {
+        *p++ = (unsigned char)((n & 0x7f) | 0x80);
+        n >>= 7;
+    }
+
+    *p++ = (unsigned char)n;
+
+    return p;
+}
+
+/* add a run to the frame, with its side cells if it has any, and note
+   the pairs it uses that aren't recorded yet; every number takes at
+   most five bytes */
+
+static void _scr_run(int y, int x, int len, const chtype *cells,
+                     const PDC_SIDE *side)
+{
+    unsigned char *p;
+    chtype prev = 0;
+    PDC_SIDE sprev;
+    int i, pair;
+    bool sided = FALSE;
+
+    for (i = 0; i < len; i++)
+    {
+        pair = PDC_CELL_PAIR(cells[i], side ? side + i : NULL);
+
+        if (!(scr_known[pair >> 3] & (1 << (pair & 7))))
+        {
+            scr_known[pair >> 3] |= 1 << (pair & 7);
+            scr_pairs[pair >> 3] |= 1 << (pair & 7);
+            scr_npairs++;
+        }
+
+        if (side && (side[i].pair || side[i].f || side[i].b))
+            sided = TRUE;
+    }
+
+    if (scr_len + 15 + (sided ? 20L : 5L) * len > scr_max)
+    {
+        long newmax = scr_len + 15 + (sided ? 20L : 5L) * len + 4096;
+        unsigned char *newbuf = realloc(scr_buf, newmax);
+
+        if (!newbuf)
+            return;
+
+        scr_buf = newbuf;
+        scr_max = newmax;
+    }
+
+    p = scr_buf + scr_len;
+
+    p = _scr_num(p, (unsigned long)(y - scr_row));
+    p = _scr_num(p, (unsigned long)x);
+    p = _scr_num(p, ((unsigned long)len << 1) | sided);
+
+    for (i = 0; i < len; i++)
+    {
+        p = _scr_num(p, (unsigned long)(cells[i] ^ prev));
+        prev = cells[i];
+    }
+
+    if (sided)
+    {
+        sprev.pair = sprev.f = sprev.b = 0;
+
+        for (i = 0; i < len; i++)
+        {
+            p = _scr_num(p, (unsigned long)(side[i].pair ^ sprev.pair));
+            p = _scr_num(p, (unsigned long)(side[i].f ^ sprev.f));
+            p = _scr_num(p, (unsigned long)(side[i].b ^ sprev.b));
+            sprev = side[i];
+        }
+    }
+
+    scr_len = (long)(p - scr_buf);
+    scr_row = y;
+    scr_runs++;
+}
+
+/* write out the frame, if there's anything in it */
+
+static void _scr_frame(void)
+{
+    unsigned long now;
+    int i;
+
+    if (SP->lines != scr_lines || SP->cols != scr_cols)
+    {
+        scr_flags |= 1;
+        scr_lines = SP->lines;
+        scr_cols = SP->cols;
+    }
+
+    if (scr_npairs)
+        scr_flags |= 4;
+
+    if (!scr_flags && !scr_runs)
+        return;
+
+    now = PDC_us_count();
+
+    _scr_put(now - scr_mark);
+    _scr_put((unsigned long)scr_flags);
+
+    scr_mark = now;
+
+    if (scr_flags & 1)
+    {
+        _scr_put((unsigned long)scr_lines);
+        _scr_put((unsigned long)scr_cols);
+    }
+
+    if (scr_flags & 2)
+        for (i = 0; i < 6; i++)
+            _scr_put((unsigned long)scr_move[i]);
+
+    if (scr_npairs)
+    {
+        _scr_put((unsigned long)scr_npairs);
+
+        for (i = 0; i < COLOR_PAIRS; i++)
+            if (scr_pairs[i >> 3] & (1 << (i & 7)))
+            {
+                int f, b;
+
+                extended_pair_content(i, &f, &b);
+
+                _scr_put((unsigned long)i);
+                _scr_put_int(f);
+                _scr_put_int(b);
+            }
+
+        memset(scr_pairs, 0, sizeof(scr_pairs));
+        scr_npairs = 0;
+    }
+
+    _scr_put((unsigned long)scr_runs);
+    fwrite(scr_buf, 1, scr_len, scr_fp);
+
+    scr_flags = 0;
+    scr_runs = 0;
+    scr_row = 0;
+    scr_len = 0;
+
+    /* if the program dies, the last frames are the ones wanted */
+
+    fflush(scr_fp);
+}
+
+/* Note that the definition of a pair has changed, so that the next
+   doupdate() repaints the cells that show it */
+
+void PDC_pair_changed(int pair)
+{
+    PDC_LOG(("PDC_pair_changed() - called: pair %d\n", pair));
+    PDC_TRACE((PDC_EV_PAIR_CHANGED, pair, 0, 0));
+
+    _pairs_changed[pair >> 3] |= 1 << (pair & 7);
+    _pairs_pending = TRUE;
+
+    if (pair >= PDC_COLOR_PAIRS)
+        _ext_pending = TRUE;
+
+    /* record it again when it's next drawn */
+
+    scr_known[pair >> 3] &= ~(1 << (pair & 7));
+}
+
+static void _pair_map_stale(int y)
+{
+    if (y < SP->pair_map_lines)
+        SP->pair_map_ok[y] = FALSE;
+}
+
+static void _pairs_clear(void)
+{
+    memset(_pairs_changed, 0, sizeof(_pairs_changed));
+    _pairs_pending = FALSE;
+    _ext_pending = FALSE;
+}
+
+/* Force a repaint of the cells in SP->lastscr that use a changed pair.
+   Each line's map of pairs is rebuilt only when the line has been
+   written since it was last built. Returns FALSE if the maps can't be
+   allocated. */
+
+static bool _repaint_pairs(void)
+{
+    int x, y, i;
+
+    if (SP->pair_map_lines != SP->lines)
+    {
+        free(SP->pair_map);
+        free(SP->pair_map_ok);
+
+        SP->pair_map = malloc(SP->lines * _MAPLINE);
+        SP->pair_map_ok = calloc(SP->lines, sizeof(bool));
+        SP->pair_map_lines = SP->lines;
+
+        if (!SP->pair_map || !SP->pair_map_ok)
+        {
+            free(SP->pair_map);
+            free(SP->pair_map_ok);
+            SP->pair_map = NULL;
+            SP->pair_map_ok = NULL;
+            SP->pair_map_lines = 0;
+
+            _pairs_clear();
+
+            return FALSE;
+        }
+    }
+
+    for (y = 0; y < SP->lines; y++)
+    {
+        unsigned char *map = SP->pair_map + y * _MAPLINE;
+        chtype *src = curscr->_y[y];
+        chtype *dest = SP->lastscr->_y[y];
+        PDC_SIDE *sdest = SP->lastscr->_side ?
+                          SP->lastscr->_side[y] : NULL;
+
+        if (!SP->pair_map_ok[y])
+        {
+            memset(map, 0, _MAPLINE);
+
+            for (x = 0; x < SP->cols; x++)
+            {
+                i = PDC_CELL_PAIR(dest[x], sdest ? sdest + x : NULL);
+
+                if (i < PDC_COLOR_PAIRS)
+                    map[i >> 3] |= 1 << (i & 7);
+                else
+                    map[_MAPSIZE] = 1;
+            }
+
+            SP->pair_map_ok[y] = TRUE;
+        }
+
+        if (!(map[_MAPSIZE] && _ext_pending))
+        {
+            for (i = 0; i < _MAPSIZE; i++)
+                if (map[i] & _pairs_changed[i])
+                    break;
+
+            if (i == _MAPSIZE)
+                continue;
+        }
+
+        for (x = 0; x < SP->cols; x++)
+        {
+            i = PDC_CELL_PAIR(dest[x], sdest ? sdest + x : NULL);
+
+            if (!(_pairs_changed[i >> 3] & (1 << (i & 7))))
+                continue;
+
+            /* make the cell differ from curscr, with or without the
+               selection, so it's redrawn */
+
+            if (dest[x] == src[x] || dest[x] == (src[x] ^ A_REVERSE))
+                dest[x] = ~src[x];
+
+            if (curscr->_firstch[y] == _NO_CHANGE ||
+                curscr->_firstch[y] > x)
+                curscr->_firstch[y] = x;
+
+            if (curscr->_lastch[y] < x)
+                curscr->_lastch[y] = x;
+        }
+
+        SP->pair_map_ok[y] = FALSE;
+    }
+
+    _pairs_clear();
+
+    return TRUE;
+}
+
+/* The mouse selection is drawn in reverse video over curscr, without
+   changing it: cells _sel_start to _sel_end - 1, counted as
+   y * COLS + x. SP->lastscr holds them as drawn. */
+
+static int _sel_start = 0, _sel_end = 0;
+
+/* mark cells start to end - 1 as changed in curscr */
+
+static void _touch_span(int start, int end)
+{
+    int y, first, last;
+
+    while (start < end)
+    {
+        y = start / COLS;
+
+        if (y >= SP->lines)
+            break;
+
+        first = start % COLS;
+        last = min(end - y * COLS, COLS) - 1;
+
+        if (curscr->_firstch[y] == _NO_CHANGE ||
+            curscr->_firstch[y] > first)
+            curscr->_firstch[y] = first;
+
+        if (curscr->_lastch[y] < last)
+            curscr->_lastch[y] = last;
+
+        start = (y + 1) * COLS;
+    }
+}
+
+/* Move the selection to cells start to end - 1, and redraw just the
+   cells that go in or out of it */
+
+void PDC_show_selection(int start, int end)
+{
+    PDC_LOG(("PDC_show_selection() - called: start %d end %d\n",
+             start, end));
+    PDC_TRACE((PDC_EV_SELECTION, start, end, 0));
+
+    if (start < 0 || start >= end)
+        start = end = 0;
+
+    if (start == _sel_start && end == _sel_end)
+        return;
+
+    if (end <= _sel_start || _sel_end <= start)
+    {
+        _touch_span(_sel_start, _sel_end);
+        _touch_span(start, end);
+    }
+    else
+    {
+        _touch_span(min(start, _sel_start), max(start, _sel_start));
+        _touch_span(min(end, _sel_end), max(end, _sel_end));
+    }
+
+    _sel_start = start;
+    _sel_end = end;
+
+    doupdate();
+}
+
+/* Return line y of curscr as it's to be drawn: the line itself, or, if
+   the selection touches it, a copy with the selection applied */
+
+static chtype *_overlay(int y)
+{
+    static chtype *buf = NULL;
+    static int bufsize = 0;
+    chtype *line = curscr->_y[y];
+    int x = max(_sel_start - y * COLS, 0);
+    int end = min(_sel_end - y * COLS, COLS);
+
+    if (x >= end)
+        return line;
+
+    if (bufsize < COLS)
+    {
+        chtype *newbuf = realloc(buf, COLS * sizeof(chtype));
+
+        if (!newbuf)
+            return line;
+
+        buf = newbuf;
+        bufsize = COLS;
+    }
+
+    memcpy(buf, line, COLS * sizeof(chtype));
+
+    for (; x < end; x++)
+        buf[x] ^= A_REVERSE;
+
+    return buf;
+}
+
+void PDC_move_hint(int y, int x, int nlines, int ncols, int toy, int tox)
+{
+    PDC_LOG(("PDC_move_hint() - called: y %d x %d nlines %d ncols %d "
+             "toy %d tox %d\n", y, x, nlines, ncols, toy, tox));
+    PDC_TRACE((PDC_EV_MOVE_HINT, y, toy, nlines));
+
+    /* a further move of the same block just changes the destination */
+
+    if (_move.pending)
+    {
+        if (y == _move.toy && x == _move.tox &&
+            nlines == _move.nlines && ncols == _move.ncols)
+        {
+            _move.toy = toy;
+            _move.tox = tox;
+        }
+        else
+            _move.pending = FALSE;
+
+        return;
+    }
+
+    _move.pending = TRUE;
+    _move.y = y;
+    _move.x = x;
+    _move.nlines = nlines;
+    _move.ncols = ncols;
+    _move.toy = toy;
+    _move.tox = tox;
+}
+
+/* Apply a pending move hint to the physical screen and SP->lastscr */
+
+static bool _do_move(void)
+{
+    int i, y = _move.y, x = _move.x, toy = _move.toy, tox = _move.tox;
+    int nlines = _move.nlines, ncols = _move.ncols;
+    chtype **lines = SP->lastscr->_y;
+    PDC_SIDE **side = SP->lastscr->_side;
+
+    _move.pending = FALSE;
+
+    if ((y == toy && x == tox) || nlines < 1 || ncols < 1 ||
+        y < 0 || x < 0 || toy < 0 || tox < 0 ||
+        max(y, toy) + nlines > SP->lines || max(x, tox) + ncols > SP->cols)
+        return FALSE;
+
+    if (!PDC_copy_area(y, x, nlines, ncols, toy, tox))
+        return FALSE;
+
+    PDC_COUNT(blits, 1);
+    PDC_COUNT(bytes_copied, (unsigned long)nlines * ncols * sizeof(chtype));
+
+    if (scr_fp)
+    {
+        scr_flags |= 2;
+        scr_move[0] = y;
+        scr_move[1] = x;
+        scr_move[2] = nlines;
+        scr_move[3] = ncols;
+        scr_move[4] = toy;
+        scr_move[5] = tox;
+    }
+
+    /* keep SP->lastscr in step with what is now on the screen */
+
+    if (toy > y)
+        for (i = nlines - 1; i >= 0; i--)
+        {
+            memmove(lines[toy + i] + tox, lines[y + i] + x,
+                    ncols * sizeof(chtype));
+            if (side)
+                memmove(side[toy + i] + tox, side[y + i] + x,
+                        ncols * sizeof(PDC_SIDE));
+        }
+    else
+        for (i = 0; i < nlines; i++)
+        {
+            memmove(lines[toy + i] + tox, lines[y + i] + x,
+                    ncols * sizeof(chtype));
+            if (side)
+                memmove(side[toy + i] + tox, side[y + i] + x,
+                        ncols * sizeof(PDC_SIDE));
+        }
+
+    for (i = toy; i < toy + nlines; i++)
+        _pair_map_stale(i);
+
+    /* the whole destination must now be compared against curscr, as
+       parts of it may belong to windows that haven't changed */
+
+    for (i = toy; i < toy + nlines; i++)
+    {
+        if (curscr->_firstch[i] == _NO_CHANGE || curscr->_firstch[i] > tox)
+            curscr->_firstch[i] = tox;
+
+        if (curscr->_lastch[i] < tox + ncols - 1)
+            curscr->_lastch[i] = tox + ncols - 1;
+    }
+
+    /* if the cursor was drawn in the block, its image moved with it */
+
+    if (SP->cursrow >= y && SP->cursrow < y + nlines &&
+        SP->curscol >= x && SP->curscol < x + ncols)
+    {
+        int cy = SP->cursrow - y + toy;
+        int cx = SP->curscol - x + tox;
+
+        PDC_transform_line(cy, cx, 1, lines[cy] + cx);
+    }
+
+    return TRUE;
+}
+
 int wnoutrefresh(WINDOW *win)
 {
     int begy, begx;     /* window's place on screen   */
     int i, j;
+    bool all;           /* whole window touched */
 
     PDC_LOG(("wnoutrefresh() - called: win=%p\n", win));
 
     if (!win)
         return ERR;
+
+    PDC_TRACE((PDC_EV_WNOUTREFRESH, win->_begy, win->_begx, win->_maxy));
     if (is_pad(win))
         return pnoutrefresh(win,
 				win->_pad._pad_y,
@@ -79,24 +716,35 @@ int wnoutrefresh(WINDOW *win)
 
     begy = win->_begy;
     begx = win->_begx;
+    all = (win->_flags & _TOUCHED) ? TRUE : FALSE;
 
     for (i = 0, j = begy; i < win->_maxy; i++, j++)
     {
-        if (win->_firstch[i] != _NO_CHANGE)
+        if (all || win->_firstch[i] != _NO_CHANGE)
         {
             chtype *src = win->_y[i];
             chtype *dest = curscr->_y[j] + begx;
+            PDC_SIDE *ssrc = win->_side ? win->_side[i] : NULL;
+            PDC_SIDE *sdest = curscr->_side ? curscr->_side[j] + begx :
+                              NULL;
+
+            /* first and last changed */
 
-            int first = win->_firstch[i]; /* first changed */
-            int last = win->_lastch[i];   /* last changed */
+            int first = all ? 0 : win->_firstch[i];
+            int last = all ? win->_maxx - 1 : win->_lastch[i];
+
+            PDC_COUNT(lines_examined, 1);
+            PDC_COUNT(cells_compared, last - first + 1);
 
             /* ignore areas on the outside that are marked as changed,
                but really aren't */
 
-            while (first <= last && src[first] == dest[first])
+            while (first <= last && src[first] == dest[first] &&
+                   (!ssrc || PDC_SIDE_SAME(ssrc[first], sdest[first])))
                 first++;
 
-            while (last >= first && src[last] == dest[last])
+            while (last >= first && src[last] == dest[last] &&
+                   (!ssrc || PDC_SIDE_SAME(ssrc[last], sdest[last])))
                 last--;
 
             /* if any have really changed... */
@@ -106,6 +754,16 @@ int wnoutrefresh(WINDOW *win)
                 memcpy(dest + first, src + first,
                        (last - first + 1) * sizeof(chtype));
 
+                PDC_COUNT(bytes_copied, (last - first + 1) * sizeof(chtype));
+
+                if (ssrc)
+                {
+                    memcpy(sdest + first, ssrc + first,
+                           (last - first + 1) * sizeof(PDC_SIDE));
+                    PDC_COUNT(bytes_copied,
+                              (last - first + 1) * sizeof(PDC_SIDE));
+                }
+
                 first += begx;
                 last += begx;
 
@@ -123,6 +781,8 @@ int wnoutrefresh(WINDOW *win)
         win->_lastch[i] = _NO_CHANGE;       /* updated now */
     }
 
+    win->_flags &= ~_TOUCHED;
+
     if (win->_clear)
         win->_clear = FALSE;
 
@@ -135,10 +795,140 @@ int wnoutrefresh(WINDOW *win)
     return OK;
 }
 
+/* TRUE if cell x of a line to be drawn differs from what's on the
+   screen, in its side cell if not in the cell itself */
+
+static bool _differs(const chtype *src, const chtype *dest,
+                     const PDC_SIDE *ssrc, const PDC_SIDE *sdest, int x)
+{
+    return src[x] != dest[x] ||
+           (ssrc && sdest && !PDC_SIDE_SAME(ssrc[x], sdest[x]));
+}
+
+/* Replay mode: the time of each frame, from one doupdate() to the
+   next, and a summary of them at exit */
+
+static unsigned long *frame_us = NULL;
+static int frames_done = 0;
+static unsigned long frame_mark;
+
+static int _cmp_ulong(const void *a, const void *b)
+{
+    unsigned long x = *(const unsigned long *)a;
+    unsigned long y = *(const unsigned long *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void _replay_report(void)
+{
+    int n = frames_done;
+
+    if (!n)
+        return;
+
+    qsort(frame_us, n, sizeof(unsigned long), _cmp_ulong);
+
+    fprintf(stderr, "PDC_REPLAY: %d frames; p50 %lu us, p99 %lu us, "
+            "max %lu us\n", n, frame_us[(n - 1) / 2],
+            frame_us[(n - 1) * 99 / 100], frame_us[n - 1]);
+}
+
+void PDC_replay_start(int frames)
+{
+    PDC_LOG(("PDC_replay_start() - called: frames=%d\n", frames));
+
+    if (frames < 1 || frame_us)
+        return;
+
+    frame_us = malloc(frames * sizeof(unsigned long));
+    if (!frame_us)
+        return;
+
+    SP->replay_frames = frames;
+    frame_mark = PDC_us_count();
+
+    atexit(_replay_report);
+}
+
+static void _replay_frame(void)
+{
+    unsigned long now = PDC_us_count();
+
+    if (frames_done == SP->replay_frames)
+        return;
+
+    frame_us[frames_done++] = now - frame_mark;
+    frame_mark = now;
+
+    /* done; ask the program to quit */
+
+    if (frames_done == SP->replay_frames)
+        PDC_post_key('q');
+}
+
+/* Add the latency of the oldest key not yet shown to the histogram */
+
+static void _latency_present(void)
+{
+    PDC_LATENCY *lat = &SP->latency;
+    unsigned long us = PDC_us_count() - SP->key_mark;
+    int i = 0;
+
+    SP->key_pending = FALSE;
+
+    while (i < PDC_LATENCY_BUCKETS - 1 && (us >> (i + 1)))
+        i++;
+
+    lat->bucket[i]++;
+    lat->count++;
+    lat->total_us += us;
+
+    if (us > lat->max_us)
+        lat->max_us = us;
+}
+
+#ifdef PDCDEBUG
+/* Draw the latency so far in the bottom right corner, and leave what
+   it covers to be put back by the next update */
+
+static void _latency_overlay(void)
+{
+    PDC_LATENCY *lat = &SP->latency;
+    chtype line[80];
+    char text[80];
+    int i, len, x, y = SP->lines - 1;
+
+    sprintf(text, " keys %lu, mean %lu us, max %lu us ", lat->count,
+            lat->count ? lat->total_us / lat->count : 0, lat->max_us);
+
+    len = (int)strlen(text);
+    if (len > SP->cols)
+        len = SP->cols;
+
+    x = SP->cols - len;
+
+    for (i = 0; i < len; i++)
+        line[i] = (unsigned char)text[i] | A_REVERSE;
+
+    PDC_transform_line(y, x, len, line);
+    memcpy(SP->lastscr->_y[y] + x, line, len * sizeof(chtype));
+
+    if (curscr->_firstch[y] == _NO_CHANGE || curscr->_firstch[y] > x)
+        curscr->_firstch[y] = x;
+
+    if (curscr->_lastch[y] < x + len - 1)
+        curscr->_lastch[y] = x + len - 1;
+}
+#endif
+
 int doupdate(void)
 {
     int y;
-    bool clearall;
+    bool clearall, drawn = FALSE;
+#ifdef PDCSTATS
+    unsigned long start, mark, drawing = 0;
+#endif
 
     PDC_LOG(("doupdate() - called\n"));
 
@@ -154,6 +944,30 @@ int doupdate(void)
     else
         clearall = curscr->_clear;
 
+    PDC_TRACE((PDC_EV_DOUPDATE, clearall, 0, 0));
+    PDC_COUNT(updates, 1);
+#ifdef PDCSTATS
+    start = PDC_us_count();
+#endif
+
+    if (_move.pending)
+    {
+        if (clearall)
+            _move.pending = FALSE;
+        else
+            drawn = _do_move();
+    }
+
+    if (_pairs_pending)
+    {
+        if (clearall)
+            _pairs_clear();
+        else if (!_repaint_pairs())
+            clearall = TRUE;
+    }
+
+    PDC_expand_touch(curscr);
+
     for (y = 0; y < SP->lines; y++)
     {
         PDC_LOG(("doupdate() - Transforming line %d of %d: %s\n",
@@ -164,8 +978,11 @@ int doupdate(void)
         {
             int first, last;
 
-            chtype *src = curscr->_y[y];
+            chtype *src = _overlay(y);
             chtype *dest = SP->lastscr->_y[y];
+            PDC_SIDE *ssrc = curscr->_side ? curscr->_side[y] : NULL;
+            PDC_SIDE *sdest = SP->lastscr->_side ?
+                              SP->lastscr->_side[y] : NULL;
 
             if (clearall)
             {
@@ -178,6 +995,12 @@ int doupdate(void)
                 last = curscr->_lastch[y];
             }
 
+            PDC_COUNT(lines_examined, 1);
+            PDC_COUNT(cells_compared, last - first + 1);
+#ifdef PDCSTATS
+            mark = PDC_us_count();
+#endif
+
             while (first <= last)
             {
                 int len = 0;
@@ -190,9 +1013,10 @@ int doupdate(void)
                     len = last - first + 1;
                 else
                     while (first + len <= last &&
-                           (src[first + len] != dest[first + len] ||
+                           (_differs(src, dest, ssrc, sdest, first + len) ||
                             (len && first + len < last &&
-                             src[first + len + 1] != dest[first + len + 1])
+                             _differs(src, dest, ssrc, sdest,
+                                      first + len + 1))
                            )
                           )
                         len++;
@@ -201,32 +1025,162 @@ int doupdate(void)
 
                 if (len)
                 {
+                    PDC_TRACE((PDC_EV_LINE, y, first, len));
+                    PDC_COUNT(runs, 1);
+                    PDC_COUNT(cells_drawn, len);
+                    PDC_COUNT(bytes_copied, len * sizeof(chtype));
                     PDC_transform_line(y, first, len, src + first);
+                    if (scr_fp)
+                        _scr_run(y, first, len, src + first,
+                                 ssrc ? ssrc + first : NULL);
                     memcpy(dest + first, src + first, len * sizeof(chtype));
+                    if (sdest)
+                    {
+                        memcpy(sdest + first, ssrc + first,
+                               len * sizeof(PDC_SIDE));
+                        PDC_COUNT(bytes_copied, len * sizeof(PDC_SIDE));
+                    }
                     first += len;
+                    drawn = TRUE;
                 }
 
                 /* skip over runs of unchanged cells */
 
-                while (first <= last && src[first] == dest[first])
+                while (first <= last &&
+                       !_differs(src, dest, ssrc, sdest, first))
                     first++;
             }
 
+#ifdef PDCSTATS
+            drawing += PDC_us_count() - mark;
+#endif
             curscr->_firstch[y] = _NO_CHANGE;
             curscr->_lastch[y] = _NO_CHANGE;
+
+            _pair_map_stale(y);
         }
     }
 
     curscr->_clear = FALSE;
 
     if (SP->visibility)
+    {
+        if (curscr->_cury != SP->cursrow || curscr->_curx != SP->curscol)
+            drawn = TRUE;
+
         PDC_gotoyx(curscr->_cury, curscr->_curx);
+    }
 
     SP->cursrow = curscr->_cury;
     SP->curscol = curscr->_curx;
 
+#ifdef PDCSTATS
+    mark = PDC_us_count();
+    SP->stats.render_us += drawing;
+    SP->stats.diff_us += mark - start - drawing;
+#endif
+    PDC_COUNT(presents, 1);
+
+#ifdef PDCDEBUG
+    if (SP->latency_overlay)
+        _latency_overlay();
+#endif
     PDC_doupdate();
 
+    /* a key's latency runs until something is shown for it */
+
+    if (SP->key_pending && drawn)
+        _latency_present();
+
+#ifdef PDCSTATS
+    SP->stats.present_us += PDC_us_count() - mark;
+#endif
+
+    PDC_TRACE((PDC_EV_DOUPDATE_END, 0, 0, 0));
+
+    if (scr_fp)
+        _scr_frame();
+
+    if (SP->replay_frames)
+        _replay_frame();
+
+    return OK;
+}
+
+int PDC_get_stats(PDC_STATS *stats, bool reset)
+{
+    PDC_LOG(("PDC_get_stats() - called\n"));
+
+#ifdef PDCSTATS
+    if (!SP || !stats)
+        return ERR;
+
+    *stats = SP->stats;
+
+    if (reset)
+        memset(&SP->stats, 0, sizeof(PDC_STATS));
+
+    return OK;
+#else
+    return ERR;
+#endif
+}
+
+int PDC_get_latency(PDC_LATENCY *latency, bool reset)
+{
+    PDC_LOG(("PDC_get_latency() - called\n"));
+
+    if (!SP || !latency)
+        return ERR;
+
+    *latency = SP->latency;
+
+    if (reset)
+        memset(&SP->latency, 0, sizeof(PDC_LATENCY));
+
+    return OK;
+}
+
+int PDC_record_screen(const char *filename)
+{
+    PDC_LOG(("PDC_record_screen() - called\n"));
+
+    if (scr_fp)
+    {
+        fclose(scr_fp);
+        scr_fp = NULL;
+    }
+
+    if (!filename)
+        return OK;
+
+    if (!SP)
+        return ERR;
+
+    scr_fp = fopen(filename, "wb");
+    if (!scr_fp)
+        return ERR;
+
+    fputs(SCREEN_MAGIC, scr_fp);
+    _scr_put((unsigned long)sizeof(chtype));
+    _scr_put((unsigned long)SP->lines);
+    _scr_put((unsigned long)SP->cols);
+
+    scr_lines = SP->lines;
+    scr_cols = SP->cols;
+    scr_flags = scr_runs = scr_row = 0;
+    scr_len = 0;
+    scr_mark = PDC_us_count();
+
+    /* start with the whole screen, which brings the pairs it shows */
+
+    memset(scr_known, 0, sizeof(scr_known));
+    memset(scr_pairs, 0, sizeof(scr_pairs));
+    scr_npairs = 0;
+
+    if (curscr)
+        curscr->_clear = TRUE;
+
     return OK;
 }
 
@@ -269,6 +1223,8 @@ int wredrawln(WINDOW *win, int start, int num)
     if (!win || start > win->_maxy || start + num > win->_maxy)
         return ERR;
 
+    PDC_TRACE((PDC_EV_REDRAWLN, win->_begy + start, num, 0));
+
     for (i = start; i < start + num; i++)
     {
         win->_firstch[i] = 0;
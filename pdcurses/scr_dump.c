@@ -62,7 +62,7 @@ scr_dump
 #include <stdlib.h>
 #include <string.h>
 
-#define DUMPVER 1   /* Should be updated whenever the WINDOW struct is
+#define DUMPVER 3   /* Should be updated whenever the WINDOW struct is
                        changed */
 
 int putwin(WINDOW *win, FILE *filep)
@@ -80,12 +80,18 @@ int putwin(WINDOW *win, FILE *filep)
     {
         int i;
 
-        /* write each line */
+        /* write each line, then its side plane, if it has one */
 
         for (i = 0; i < win->_maxy && win->_y[i]; i++)
             if (!fwrite(win->_y[i], win->_maxx * sizeof(chtype), 1, filep))
                 return ERR;
 
+        if (win->_side)
+            for (i = 0; i < win->_maxy; i++)
+                if (!fwrite(win->_side[i], win->_maxx * sizeof(PDC_SIDE),
+                            1, filep))
+                    return ERR;
+
         return OK;
     }
 
@@ -94,55 +100,40 @@ int putwin(WINDOW *win, FILE *filep)
 
 WINDOW *getwin(FILE *filep)
 {
-    WINDOW *win;
+    WINDOW *win, saved;
     char marker[4];
-    int i, nlines, ncols;
+    int i, ext = 0, nlines, ncols;
+    bool side;
 
     PDC_LOG(("getwin() - called\n"));
 
-    win = malloc(sizeof(WINDOW));
-    if (!win)
-        return (WINDOW *)NULL;
-
     /* check for the marker, and load the WINDOW struct */
 
     if (!filep || !fread(marker, 4, 1, filep) || strncmp(marker, "PDC", 3)
-        || marker[3] != DUMPVER || !fread(win, sizeof(WINDOW), 1, filep))
-    {
-        free(win);
+        || marker[3] != DUMPVER || !fread(&saved, sizeof(WINDOW), 1, filep))
         return (WINDOW *)NULL;
-    }
 
-    nlines = win->_maxy;
-    ncols = win->_maxx;
+    nlines = saved._maxy;
+    ncols = saved._maxx;
+    side = !!saved._side;
 
-    /* allocate the line pointer array */
+    /* allocate the window, and its line pointer and change arrays */
 
-    win->_y = malloc(nlines * sizeof(chtype *));
-    if (!win->_y)
-    {
-        free(win);
+    win = PDC_makenew(nlines, ncols, saved._begy, saved._begx);
+    if (!win)
         return (WINDOW *)NULL;
-    }
 
-    /* allocate the minchng and maxchng arrays */
+    saved._y = win->_y;
+    saved._firstch = win->_firstch;
+    saved._lastch = win->_lastch;
+    saved._side = (PDC_SIDE **)NULL;
 
-    win->_firstch = malloc(nlines * sizeof(int));
-    if (!win->_firstch)
-    {
-        free(win->_y);
-        free(win);
-        return (WINDOW *)NULL;
-    }
+    /* it has its own lines now, even if it was saved from a subwindow */
 
-    win->_lastch = malloc(nlines * sizeof(int));
-    if (!win->_lastch)
-    {
-        free(win->_firstch);
-        free(win->_y);
-        free(win);
-        return (WINDOW *)NULL;
-    }
+    saved._flags &= ~(_BATCHED|_SUBWIN|_SUBPAD);
+    saved._parent = (WINDOW *)NULL;
+
+    *win = saved;
 
     /* allocate the lines */
 
@@ -161,6 +152,28 @@ WINDOW *getwin(FILE *filep)
         }
     }
 
+    /* a saved side plane may hold extended pairs and direct colors, so
+       the pair table must be enlarged, and every window given a plane,
+       to load it */
+
+    if (side)
+    {
+        if (PDC_opts_pair(0, &ext) == -1 || !PDC_side_enable())
+        {
+            delwin(win);
+            return (WINDOW *)NULL;
+        }
+
+        for (i = 0; i < nlines; i++)
+        {
+            if (!fread(win->_side[i], ncols * sizeof(PDC_SIDE), 1, filep))
+            {
+                delwin(win);
+                return (WINDOW *)NULL;
+            }
+        }
+    }
+
     touchwin(win);
 
     return win;
@@ -40,6 +40,8 @@ scroll
 
 **man-end****************************************************************/
 
+#include <string.h>
+
 int wscrl(WINDOW *win, int n)
 {
     int i, l, dir, start, end;
@@ -76,6 +78,17 @@ int wscrl(WINDOW *win, int n)
 
         win->_y[end] = temp;
 
+        if (win->_side)
+        {
+            PDC_SIDE *stemp = win->_side[start];
+
+            for (i = start; i != end; i += dir)
+                win->_side[i] = win->_side[i + dir];
+
+            win->_side[end] = stemp;
+            memset(stemp, 0, win->_maxx * sizeof(PDC_SIDE));
+        }
+
         /* make a blank line */
 
         for (i = 0; i < win->_maxx; i++)
@@ -18,6 +18,8 @@ touch
 
     int touchoverlap(const WINDOW *win1, WINDOW *win2);
 
+    void PDC_expand_touch(WINDOW *win);
+
 ### Description
 
    touchwin() and touchline() throw away all information about which
@@ -43,6 +45,12 @@ touch
    touchoverlap(win1, win2) marks the portion of win2 which overlaps
    with win1 as modified.
 
+   touchwin() only sets a flag on the window, which wnoutrefresh(),
+   is_linetouched() and is_wintouched() honor directly. Internal code
+   that needs the per-line ranges to be accurate calls
+   PDC_expand_touch(), which writes the flag out to every line and
+   clears it.
+
 ### Return Value
 
    All functions return OK on success and ERR on error except
@@ -62,14 +70,14 @@ touch
 
 **man-end****************************************************************/
 
-int touchwin(WINDOW *win)
+void PDC_expand_touch(WINDOW *win)
 {
     int i;
 
-    PDC_LOG(("touchwin() - called: Win=%x\n", win));
+    PDC_LOG(("PDC_expand_touch() - called: win=%p\n", win));
 
-    if (!win)
-        return ERR;
+    if (!(win->_flags & _TOUCHED))
+        return;
 
     for (i = 0; i < win->_maxy; i++)
     {
@@ -77,6 +85,18 @@ int touchwin(WINDOW *win)
         win->_lastch[i] = win->_maxx - 1;
     }
 
+    win->_flags &= ~_TOUCHED;
+}
+
+int touchwin(WINDOW *win)
+{
+    PDC_LOG(("touchwin() - called: Win=%x\n", win));
+
+    if (!win)
+        return ERR;
+
+    win->_flags |= _TOUCHED;
+
     return OK;
 }
 
@@ -108,6 +128,8 @@ int untouchwin(WINDOW *win)
     if (!win)
         return ERR;
 
+    win->_flags &= ~_TOUCHED;
+
     for (i = 0; i < win->_maxy; i++)
     {
         win->_firstch[i] = _NO_CHANGE;
@@ -127,6 +149,9 @@ int wtouchln(WINDOW *win, int y, int n, int changed)
     if (!win || y > win->_maxy || y + n > win->_maxy)
         return ERR;
 
+    if (!changed)
+        PDC_expand_touch(win);
+
     for (i = y; i < y + n; i++)
     {
         if (changed)
@@ -151,6 +176,9 @@ bool is_linetouched(WINDOW *win, int line)
     if (!win || line > win->_maxy || line < 0)
         return FALSE;
 
+    if (win->_flags & _TOUCHED)
+        return TRUE;
+
     return (win->_firstch[line] != _NO_CHANGE) ? TRUE : FALSE;
 }
 
@@ -160,6 +188,9 @@ bool is_wintouched(WINDOW *win)
 
     PDC_LOG(("is_wintouched() - called: win=%p\n", win));
 
+    if (win && (win->_flags & _TOUCHED))
+        return TRUE;
+
     if (win)
         for (i = 0; i < win->_maxy; i++)
             if (win->_firstch[i] != _NO_CHANGE)
@@ -39,11 +39,14 @@ util
    cchar_t pointed to by wcval and stores the attributes in attrs, the
    color pair in color_pair, and the text in the wide-character string
    wch. When wch is NULL, getcchar() merely returns the number of wide
-   characters in wcval. In either mode, the opts argument is unused.
+   characters in wcval. If opts is not NULL, the color pair is also
+   stored in the int it points to.
 
    setcchar constructs a cchar_t at wcval from the wide-character text
-   at wch, the attributes in attr and the color pair in color_pair. The
-   opts argument is unused.
+   at wch, the attributes in attr and the color pair in color_pair. If
+   opts is not NULL, it points to an int holding the color pair, as in
+   wcolor_set(); but a cchar_t has room only for pairs below 256, and
+   setcchar() returns ERR for higher ones.
 
    Currently, the length returned by getcchar() is always 1 or 0.
    Similarly, setcchar() will only take the first wide character from
@@ -140,6 +143,9 @@ int getcchar(const cchar_t *wcval, wchar_t *wch, attr_t *attrs,
         *attrs = (*wcval & (A_ATTRIBUTES & ~A_COLOR));
         *color_pair = PAIR_NUMBER(*wcval & A_COLOR);
 
+        if (opts)
+            *((int *)opts) = *color_pair;
+
         if (*wch)
             *++wch = L'\0';
 
@@ -152,10 +158,12 @@ int getcchar(const cchar_t *wcval, wchar_t *wch, attr_t *attrs,
 int setcchar(cchar_t *wcval, const wchar_t *wch, const attr_t attrs,
              short color_pair, const void *opts)
 {
-    if (!wcval || !wch)
+    int pair = opts ? *((const int *)opts) : color_pair;
+
+    if (!wcval || !wch || pair < 0 || pair >= PDC_COLOR_PAIRS)
         return ERR;
 
-    *wcval = *wch | attrs | COLOR_PAIR(color_pair);
+    *wcval = *wch | attrs | COLOR_PAIR(pair);
 
     return OK;
 }
@@ -31,6 +31,8 @@ window
     WINDOW *PDC_makelines(WINDOW *win);
     WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx);
     void PDC_sync(WINDOW *win);
+    int PDC_begin_batch(void);
+    int PDC_end_batch(void);
 
 ### Description
 
@@ -98,19 +100,31 @@ window
    PDC_makenew() allocates all data for a new WINDOW * except the actual
    lines themselves. If it's unable to allocate memory for the window
    structure, it will free all allocated memory and return a NULL
-   pointer.
+   pointer. It also adds the window to SP->win_list, the list of all
+   windows, which delwin() removes it from.
+
+   PDC_side_enable() gives every window a side plane, for data that
+   doesn't fit in its cells, such as extended color pairs; windows made
+   after that get one too. It returns FALSE if it runs out of memory.
 
    PDC_makelines() allocates the memory for the lines.
 
    PDC_sync() handles wrefresh() and wsyncup() calls when a window is
    changed.
 
+   PDC_begin_batch() and PDC_end_batch() bracket a group of updates.
+   Between them, PDC_sync() only records which windows are due a
+   wrefresh() (immedok()) or wsyncup() (syncok()). PDC_end_batch()
+   then does each window's wsyncup() once, and a single refresh of all
+   the immedok() windows. Batches may be nested; only the outermost
+   PDC_end_batch() does the deferred work.
+
 ### Return Value
 
    newwin(), subwin(), derwin() and dupwin() return a pointer to the new
-   window, or NULL on failure. delwin(), mvwin(), mvderwin() and
-   syncok() return OK or ERR. wsyncup(), wcursyncup() and wsyncdown()
-   return nothing.
+   window, or NULL on failure. delwin(), mvwin(), mvderwin(), syncok(),
+   PDC_begin_batch() and PDC_end_batch() return OK or ERR. wsyncup(),
+   wcursyncup() and wsyncdown() return nothing.
 
    is_subwin() and is_syncok() returns TRUE or FALSE.
 
@@ -146,10 +160,188 @@ window
    PDC_makelines         |    -   |    -    |   -
    PDC_makenew           |    -   |    -    |   -
    PDC_sync              |    -   |    -    |   -
+   PDC_begin_batch       |    -   |    -    |   -
+   PDC_end_batch         |    -   |    -    |   -
 
 **man-end****************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
+
+/* Keep track of every window, for PDC_side_enable() */
+
+static bool _list_add(WINDOW *win)
+{
+    if (!SP)
+        return TRUE;
+
+    if (SP->win_count >= SP->win_max)
+    {
+        int newmax = SP->win_max ? SP->win_max * 2 : 16;
+        WINDOW **wins = realloc(SP->win_list, newmax * sizeof(WINDOW *));
+
+        if (!wins)
+            return FALSE;
+
+        SP->win_list = wins;
+        SP->win_max = newmax;
+    }
+
+    SP->win_list[SP->win_count++] = win;
+
+    return TRUE;
+}
+
+/* Search from the end, as the newest windows tend to go first */
+
+static void _list_remove(WINDOW *win)
+{
+    int i;
+
+    if (!SP)
+        return;
+
+    for (i = SP->win_count - 1; i >= 0; i--)
+        if (SP->win_list[i] == win)
+        {
+            SP->win_list[i] = SP->win_list[--(SP->win_count)];
+            break;
+        }
+}
+
+/* Side planes. A window with lines of its own has plane lines of its
+   own, kept in step with _y; a subwindow's point into its parent's, as
+   its _y lines do. */
+
+static bool _side_lines(WINDOW *win)
+{
+    int i;
+
+    win->_side = malloc(win->_maxy * sizeof(PDC_SIDE *));
+    if (!win->_side)
+        return FALSE;
+
+    for (i = 0; i < win->_maxy; i++)
+    {
+        win->_side[i] = calloc(win->_maxx, sizeof(PDC_SIDE));
+        if (!win->_side[i])
+        {
+            while (i--)
+                free(win->_side[i]);
+
+            free(win->_side);
+            win->_side = NULL;
+
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static void _side_free(WINDOW *win)
+{
+    int i;
+
+    if (!win->_side)
+        return;
+
+    if (!(win->_flags & (_SUBWIN|_SUBPAD)))
+        for (i = 0; i < win->_maxy; i++)
+            free(win->_side[i]);
+
+    free(win->_side);
+    win->_side = NULL;
+}
+
+/* Point a subwindow's plane into its parent's, for each line by finding
+   the parent line that its _y line lies in -- the parent may have
+   scrolled since the subwindow was made */
+
+static bool _side_share(WINDOW *win)
+{
+    WINDOW *par = win->_parent;
+    int i, j;
+
+    win->_side = malloc(win->_maxy * sizeof(PDC_SIDE *));
+    if (!win->_side)
+        return FALSE;
+
+    for (i = 0; i < win->_maxy; i++)
+    {
+        win->_side[i] = par->_side[0];
+
+        for (j = 0; j < par->_maxy; j++)
+            if (win->_y[i] >= par->_y[j] &&
+                win->_y[i] < par->_y[j] + par->_maxx)
+            {
+                win->_side[i] = par->_side[j] + (win->_y[i] - par->_y[j]);
+                break;
+            }
+    }
+
+    return TRUE;
+}
+
+/* Give every window a plane, the subwindows after their parents; new
+   windows then get one as they're made */
+
+bool PDC_side_enable(void)
+{
+    WINDOW *win;
+    int i, left;
+    bool ok = TRUE, progress = TRUE;
+
+    PDC_LOG(("PDC_side_enable() - called\n"));
+
+    if (!SP)
+        return FALSE;
+
+    if (SP->side_plane)
+        return TRUE;
+
+    for (i = 0; ok && i < SP->win_count; i++)
+    {
+        win = SP->win_list[i];
+
+        if (!(win->_flags & (_SUBWIN|_SUBPAD)))
+            ok = _side_lines(win);
+    }
+
+    for (left = 1; ok && left && progress;)
+    {
+        left = 0;
+        progress = FALSE;
+
+        for (i = 0; ok && i < SP->win_count; i++)
+        {
+            win = SP->win_list[i];
+
+            if (!(win->_flags & (_SUBWIN|_SUBPAD)) || win->_side)
+                continue;
+
+            if (win->_parent && win->_parent->_side)
+            {
+                ok = _side_share(win);
+                progress = TRUE;
+            }
+            else
+                left++;
+        }
+    }
+
+    if (!ok)
+    {
+        for (i = 0; i < SP->win_count; i++)
+            _side_free(SP->win_list[i]);
+
+        return FALSE;
+    }
+
+    SP->side_plane = TRUE;
+
+    return TRUE;
+}
 
 WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx)
 {
@@ -184,8 +376,9 @@ WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx)
     }
 
     win->_lastch = malloc(nlines * sizeof(int));
-    if (!win->_lastch)
+    if (!win->_lastch || !_list_add(win))
     {
+        free(win->_lastch);
         free(win->_firstch);
         free(win->_y);
         free(win);
@@ -212,9 +405,10 @@ WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx)
     win->_pad._pad_bottom = -1;
     win->_pad._pad_right = -1;
 
-    /* init to say window all changed */
+    /* init to say window all changed; done per line, since callers
+       may overwrite _flags */
 
-    touchwin(win);
+    wtouchln(win, 0, nlines, 1);
 
     return win;
 }
@@ -235,34 +429,161 @@ WINDOW *PDC_makelines(WINDOW *win)
     {
         win->_y[i] = malloc(ncols * sizeof(chtype));
         if (!win->_y[i])
-        {
-            /* if error, free all the data */
+            break;
+    }
 
-            for (j = 0; j < i; j++)
-                free(win->_y[j]);
+    if (i < nlines || (SP && SP->side_plane && !_side_lines(win)))
+    {
+        /* if error, free all the data */
 
-            free(win->_firstch);
-            free(win->_lastch);
-            free(win->_y);
-            free(win);
+        for (j = 0; j < i; j++)
+            free(win->_y[j]);
 
-            return (WINDOW *)NULL;
-        }
+        _list_remove(win);
+
+        free(win->_firstch);
+        free(win->_lastch);
+        free(win->_y);
+        free(win);
+
+        return (WINDOW *)NULL;
     }
 
     return win;
 }
 
+/* Record win for PDC_end_batch(), once per batch */
+
+static void _batch_add(WINDOW *win)
+{
+    if (win->_flags & _BATCHED)
+        return;
+
+    if (SP->batch_count >= SP->batch_max)
+    {
+        int newmax = SP->batch_max ? SP->batch_max * 2 : 16;
+        WINDOW **wins = realloc(SP->batch_wins, newmax * sizeof(WINDOW *));
+
+        /* out of memory: fall back to syncing right away */
+
+        if (!wins)
+        {
+            if (win->_immed)
+                wrefresh(win);
+            if (win->_sync)
+                wsyncup(win);
+
+            return;
+        }
+
+        SP->batch_wins = wins;
+        SP->batch_max = newmax;
+    }
+
+    win->_flags |= _BATCHED;
+    SP->batch_wins[SP->batch_count++] = win;
+}
+
+/* Forget win, if it's pending; called from delwin() */
+
+static void _batch_remove(WINDOW *win)
+{
+    int i;
+
+    for (i = 0; i < SP->batch_count; i++)
+        if (SP->batch_wins[i] == win)
+        {
+            SP->batch_wins[i] = SP->batch_wins[--(SP->batch_count)];
+            break;
+        }
+
+    win->_flags &= ~_BATCHED;
+}
+
 void PDC_sync(WINDOW *win)
 {
     PDC_LOG(("PDC_sync() - called:\n"));
 
+    if (SP && SP->batch_depth)
+    {
+        if (win->_immed || win->_sync)
+            _batch_add(win);
+
+        return;
+    }
+
     if (win->_immed)
         wrefresh(win);
     if (win->_sync)
         wsyncup(win);
 }
 
+int PDC_begin_batch(void)
+{
+    PDC_LOG(("PDC_begin_batch() - called: depth %d\n",
+             SP ? SP->batch_depth : -1));
+
+    if (!SP)
+        return ERR;
+
+    SP->batch_depth++;
+
+    return OK;
+}
+
+int PDC_end_batch(void)
+{
+    int i, refresh;
+
+    PDC_LOG(("PDC_end_batch() - called: depth %d\n",
+             SP ? SP->batch_depth : -1));
+
+    if (!SP || !SP->batch_depth)
+        return ERR;
+
+    if (--(SP->batch_depth))
+        return OK;
+
+    /* Ancestors first, so that the refreshes below see their changes */
+
+    for (i = 0; i < SP->batch_count; i++)
+    {
+        WINDOW *win = SP->batch_wins[i];
+
+        win->_flags &= ~_BATCHED;
+
+        if (win->_sync)
+            wsyncup(win);
+    }
+
+    refresh = FALSE;
+
+    for (i = 0; i < SP->batch_count; i++)
+    {
+        WINDOW *win = SP->batch_wins[i];
+
+        /* as wrefresh(), but with only one doupdate() */
+
+        if (win->_immed && !(win->_flags & (_PAD|_SUBPAD)))
+        {
+            if (win->_clear && win->_maxy == SP->lines &&
+                win->_maxx == SP->cols)
+                curscr->_clear = TRUE;
+
+            if (win == curscr)
+                curscr->_clear = TRUE;
+            else
+                wnoutrefresh(win);
+
+            refresh = TRUE;
+        }
+    }
+
+    SP->batch_count = 0;
+
+    return refresh ? doupdate() : OK;
+}
+
 WINDOW *newwin(int nlines, int ncols, int begy, int begx)
 {
     WINDOW *win;
@@ -297,6 +618,12 @@ int delwin(WINDOW *win)
     if (!win)
         return ERR;
 
+    if (win->_flags & _BATCHED)
+        _batch_remove(win);
+
+    _list_remove(win);
+    _side_free(win);
+
     /* subwindows use parents' lines */
 
     if (!(win->_flags & (_SUBWIN|_SUBPAD)))
@@ -374,6 +701,22 @@ WINDOW *subwin(WINDOW *orig, int nlines, int ncols, int begy, int begx)
 
     win->_flags |= _SUBWIN;
 
+    /* share the parent's side plane, as with the lines */
+
+    if (orig->_side)
+    {
+        win->_sideattr = orig->_sideattr;
+        win->_side = malloc(nlines * sizeof(PDC_SIDE *));
+        if (!win->_side)
+        {
+            delwin(win);
+            return (WINDOW *)NULL;
+        }
+
+        for (i = 0, j = win->_pary; i < nlines; i++, j++)
+            win->_side[i] = orig->_side[j] + k;
+    }
+
     return win;
 }
 
@@ -401,6 +744,10 @@ int mvderwin(WINDOW *win, int pary, int parx)
     for (i = 0; i < win->_maxy; i++)
         win->_y[i] = (mypar->_y[j++]) + parx;
 
+    if (win->_side && mypar->_side)
+        for (i = 0, j = pary; i < win->_maxy; i++)
+            win->_side[i] = (mypar->_side[j++]) + parx;
+
     win->_pary = pary;
     win->_parx = parx;
 
@@ -436,6 +783,9 @@ WINDOW *dupwin(WINDOW *win)
              ptr < new->_y[i] + ncols; ptr++, ptr1++)
             *ptr = *ptr1;
 
+        if (new->_side && win->_side)
+            memcpy(new->_side[i], win->_side[i], ncols * sizeof(PDC_SIDE));
+
         new->_firstch[i] = 0;
         new->_lastch[i] = ncols - 1;
     }
@@ -446,7 +796,7 @@ WINDOW *dupwin(WINDOW *win)
     new->_maxx = win->_maxx;
     new->_begy = win->_begy;
     new->_begx = win->_begx;
-    new->_flags = win->_flags;
+    new->_flags = win->_flags & ~_BATCHED;
     new->_attrs = win->_attrs;
     new->_clear = win->_clear;
     new->_leaveit = win->_leaveit;
@@ -460,7 +810,8 @@ WINDOW *dupwin(WINDOW *win)
     new->_pary = win->_pary;
     new->_parent = win->_parent;
     new->_bkgd = win->_bkgd;
-    new->_flags = win->_flags;
+    new->_sideattr = win->_sideattr;
+    new->_flags = win->_flags & ~_BATCHED;
 
     return new;
 }
@@ -559,7 +910,12 @@ WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
     free(win->_lastch);
     free(win->_y);
 
+    _side_free(win);
+    new->_sideattr = win->_sideattr;
+
     *win = *new;
+
+    _list_remove(new);
     free(new);
 
     return win;
@@ -17,6 +17,7 @@
 
 static SDL_Rect uprect[MAXRECT];       /* table of rects to update */
 static chtype oldch = (chtype)(-1);    /* current attribute */
+static int oldpair = -1;               /* current pair */
 static int rectcount = 0;              /* index into uprect */
 static short foregr = -2, backgr = -2; /* current foreground, background */
 static bool blinked_off = FALSE;
@@ -39,9 +40,9 @@ void PDC_update_rects(void)
     }
 }
 
-/* set the font colors to match the chtype's attribute */
+/* set the font colors to match the chtype's attribute and pair */
 
-static void _set_attr(chtype ch)
+static void _set_attr(chtype ch, int pair)
 {
     attr_t sysattrs = SP->termattrs;
 
@@ -53,16 +54,16 @@ static void _set_attr(chtype ch)
             TTF_STYLE_ITALIC : 0) );
 #endif
 
-    ch &= (A_COLOR|A_BOLD|A_BLINK|A_REVERSE);
+    ch &= (A_BOLD|A_BLINK|A_REVERSE);
 
-    if (oldch != ch)
+    if (oldch != ch || oldpair != pair)
     {
         short newfg, newbg;
 
         if (SP->mono)
             return;
 
-        pair_content(PAIR_NUMBER(ch), &newfg, &newbg);
+        pair_content(pair, &newfg, &newbg);
 
         if ((ch & A_BOLD) && !(sysattrs & A_BOLD))
             newfg |= 8;
@@ -103,6 +104,7 @@ static void _set_attr(chtype ch)
         }
 
         oldch = ch;
+        oldpair = pair;
     }
 }
 
@@ -246,7 +248,7 @@ void PDC_gotoyx(int row, int col)
 
     ch = curscr->_y[row][col] ^ A_REVERSE;
 
-    _set_attr(ch);
+    _set_attr(ch, PDC_CELL_PAIR(ch, PDC_SIDE_AT(curscr, row, col)));
 
     src.h = (SP->visibility == 1) ? pdc_fheight >> 2 : pdc_fheight;
     src.w = pdc_fwidth;
@@ -301,7 +303,8 @@ void PDC_gotoyx(int row, int col)
     }
 }
 
-void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
+void _new_packet(attr_t attr, int pair, int lineno, int x, int len,
+                 const chtype *srcp)
 {
     SDL_Rect src, dest, lastrect;
     int j;
@@ -312,6 +315,8 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
     short hcol = SP->line_color;
     bool blink = blinked_off && (attr & A_BLINK) && (sysattrs & A_BLINK);
 
+    PDC_COUNT(packets, 1);
+
     if (rectcount == MAXRECT)
         PDC_update_rects();
 
@@ -345,7 +350,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
     else
         uprect[rectcount++] = dest;
 
-    _set_attr(attr);
+    _set_attr(attr, pair);
 
     if (backgr == -1)
         SDL_LowerBlit(pdc_tileback, &dest, pdc_screen, &dest);
@@ -452,28 +457,34 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
 
 void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
 {
+    const PDC_SIDE *side = PDC_SIDE_AT(curscr, lineno, x);
     attr_t old_attr, attr;
-    int i, j;
+    int i, j, old_pair, pair;
 
     PDC_LOG(("PDC_transform_line() - called: lineno=%d\n", lineno));
 
     old_attr = *srcp & (A_ATTRIBUTES ^ A_ALTCHARSET);
+    old_pair = PDC_CELL_PAIR(*srcp, side);
 
     for (i = 1, j = 1; j < len; i++, j++)
     {
         attr = srcp[i] & (A_ATTRIBUTES ^ A_ALTCHARSET);
+        pair = PDC_CELL_PAIR(srcp[i], side ? side + i : NULL);
 
-        if (attr != old_attr)
+        if (attr != old_attr || pair != old_pair)
         {
-            _new_packet(old_attr, lineno, x, i, srcp);
+            _new_packet(old_attr, old_pair, lineno, x, i, srcp);
             old_attr = attr;
+            old_pair = pair;
             srcp += i;
+            if (side)
+                side += i;
             x += i;
             i = 0;
         }
     }
 
-    _new_packet(old_attr, lineno, x, i, srcp);
+    _new_packet(old_attr, old_pair, lineno, x, i, srcp);
 }
 
 static Uint32 _blink_timer(Uint32 interval, void *param)
@@ -523,6 +534,13 @@ void PDC_blink_text(void)
     oldch = (chtype)(-1);
 }
 
+bool PDC_copy_area(int y, int x, int nlines, int ncols, int toy, int tox)
+{
+    PDC_LOG(("PDC_copy_area() - called: not supported\n"));
+
+    return FALSE;
+}
+
 void PDC_doupdate(void)
 {
     PDC_napms(1);
@@ -86,6 +86,43 @@ bool PDC_check_key(void)
     return haveevent;
 }
 
+/* PDC_wait_key() checks for posted keys as often as for input, so
+   there's nothing to wake */
+
+void PDC_wakeup(void)
+{
+}
+
+/* SDL 1.2 has no SDL_WaitEventTimeout(), so check every 10ms */
+
+bool PDC_wait_key(int *ms)
+{
+    Uint32 start = SDL_GetTicks();
+    int left = *ms;
+
+    PDC_LOG(("PDC_wait_key() - called: ms=%d\n", *ms));
+
+    for (;;)
+    {
+        bool ready = PDC_key_posted() || PDC_check_key();
+
+        if (*ms >= 0)
+            left = max(*ms - (int)(SDL_GetTicks() - start), 0);
+
+        if (ready)
+            break;
+
+        if (!left)
+            return FALSE;
+
+        PDC_napms((left < 0 || left > 10) ? 10 : left);
+    }
+
+    *ms = left;
+
+    return TRUE;
+}
+
 static int _process_key_event(void)
 {
     int i, key = 0;
@@ -308,6 +345,9 @@ static int _process_mouse_event(void)
 
 int PDC_get_key(void)
 {
+    PDC_TRACE((PDC_EV_INPUT, event.type, (event.type == SDL_KEYDOWN ||
+               event.type == SDL_KEYUP) ? event.key.keysym.sym : 0, 0));
+
     switch (event.type)
     {
     case SDL_QUIT:
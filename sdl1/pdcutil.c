@@ -7,6 +7,16 @@ void PDC_beep(void)
     PDC_LOG(("PDC_beep() - called\n"));
 }
 
+unsigned long PDC_ms_count(void)
+{
+    return SDL_GetTicks();
+}
+
+unsigned long PDC_us_count(void)
+{
+    return SDL_GetTicks() * 1000UL;
+}
+
 void PDC_napms(int ms)
 {
     PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
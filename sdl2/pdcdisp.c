@@ -45,9 +45,10 @@ static int _is_wide_char(chtype ch)
 #endif
 
 static SDL_Rect uprect[MAXRECT];       /* table of rects to update */
-static chtype oldch = (chtype)(-1);    /* current attribute */
 static int rectcount = 0;              /* index into uprect */
-static short foregr = -2, backgr = -2; /* current foreground, background */
+static int foregr = -2, backgr = -2;   /* current foreground, background */
+static SDL_Color fgcolor;              /* foregr, for the font */
+static Uint32 fgmapped, bgmapped;      /* foregr and backgr, for FillRect() */
 static bool blinked_off = FALSE;
 
 /* do the real updates on a delay */
@@ -99,70 +100,171 @@ void PDC_update_rects(void)
     }
 }
 
-/* set the font colors to match the chtype's attribute */
+/* Resolved drawing styles, for the A_BOLD, A_BLINK, A_REVERSE and
+   A_ITALIC bits of the attribute, in a table mapped directly from the
+   pair's low bits. An entry holds while its pair and gen match, and
+   its count matches the pair's, which changes whenever the pair does;
+   PDC_reset_styles() drops them all. Cells with direct colors from the
+   side plane aren't cached; they share the extra entry at RGB_STYLE. */
 
-static void _set_attr(chtype ch)
+#define RGB_STYLE (PDC_COLOR_PAIRS << 4)
+
+static struct
 {
-    attr_t sysattrs = SP->termattrs;
+    int pair, gen, count;
+    int fore, back;       /* colors to draw with, after bold, blink and
+                             reverse */
+    SDL_Color fgc, bgc;   /* the same, resolved */
+    Uint32 fgmap, bgmap;
+#ifdef PDC_WIDE
+    int font;             /* TTF font style */
+#endif
+} styles[RGB_STYLE + 1];
+
+static int style_gen = 1;
+#ifdef PDC_WIDE
+static int fontstyle = -1;
+#endif
+
+void PDC_reset_styles(void)
+{
+    style_gen++;
+
+    /* the palette entries and font behind these may have changed too */
+
+    foregr = backgr = -2;
+#ifdef PDC_WIDE
+    fontstyle = -1;
+#endif
+}
+
+/* Resolve a color number or PDC_RGB_COLOR() value; -1 is left as the
+   transparent background */
+
+static void _resolve(int color, SDL_Color *c, Uint32 *mapped)
+{
+    if (PDC_IS_RGB(color))
+    {
+        c->r = PDC_RED(color);
+        c->g = PDC_GREEN(color);
+        c->b = PDC_BLUE(color);
+        c->a = 255;
+        *mapped = SDL_MapRGB(pdc_screen->format, c->r, c->g, c->b);
+    }
+    else if (color >= 0)
+    {
+        *c = pdc_color[color];
+        *mapped = pdc_mapped[color];
+    }
+}
+
+static int _get_style(chtype ch, int pair, const PDC_SIDE *side)
+{
+    bool rgb = PDC_SIDE_RGB(side);
+    int i = rgb ? RGB_STYLE : ((pair & (PDC_COLOR_PAIRS - 1)) << 4) |
+            ((ch >> 20) & 0x0e) | ((ch >> 19) & 1);
+    attr_t sysattrs;
+    int fore, back;
+
+    if (!rgb && styles[i].pair == pair && styles[i].gen == style_gen &&
+        styles[i].count == SP->atrtab[pair].count)
+        return i;
+
+    sysattrs = SP->termattrs;
 
 #ifdef PDC_WIDE
-    TTF_SetFontStyle(pdc_ttffont,
+    styles[i].font =
         ( ((ch & A_BOLD) && (sysattrs & A_BOLD)) ?
             TTF_STYLE_BOLD : 0) |
         ( ((ch & A_ITALIC) && (sysattrs & A_ITALIC)) ?
-            TTF_STYLE_ITALIC : 0) );
+            TTF_STYLE_ITALIC : 0);
 #endif
 
-    ch &= (A_COLOR|A_BOLD|A_BLINK|A_REVERSE);
+    extended_pair_content(pair, &fore, &back);
 
-    if (oldch != ch)
+    if ((ch & A_BOLD) && !(sysattrs & A_BOLD))
+        fore |= 8;
+    if ((ch & A_BLINK) && !(sysattrs & A_BLINK))
+        back |= 8;
+
+    if (rgb)
     {
-        short newfg, newbg;
+        if (side->f)
+            fore = side->f;
+        if (side->b)
+            back = side->b;
+    }
 
-        if (SP->mono)
-            return;
+    if (ch & A_REVERSE)
+    {
+        styles[i].fore = back;
+        styles[i].back = fore;
+    }
+    else
+    {
+        styles[i].fore = fore;
+        styles[i].back = back;
+    }
 
-        pair_content(PAIR_NUMBER(ch), &newfg, &newbg);
+    if (!SP->mono)
+    {
+        _resolve(styles[i].fore, &styles[i].fgc, &styles[i].fgmap);
+        _resolve(styles[i].back, &styles[i].bgc, &styles[i].bgmap);
+    }
 
-        if ((ch & A_BOLD) && !(sysattrs & A_BOLD))
-            newfg |= 8;
-        if ((ch & A_BLINK) && !(sysattrs & A_BLINK))
-            newbg |= 8;
+    styles[i].pair = pair;
+    styles[i].gen = style_gen;
+    styles[i].count = SP->atrtab[pair].count;
 
-        if (ch & A_REVERSE)
-        {
-            short tmp = newfg;
-            newfg = newbg;
-            newbg = tmp;
-        }
+    return i;
+}
 
-        if (newfg != foregr)
-        {
+/* set the font colors to match the chtype's attribute and pair, or the
+   cell's direct colors */
+
+static void _set_attr(chtype ch, int pair, const PDC_SIDE *side)
+{
+    int i = _get_style(ch, pair, side);
+    int newfg = styles[i].fore, newbg = styles[i].back;
+
+#ifdef PDC_WIDE
+    if (styles[i].font != fontstyle)
+    {
+        TTF_SetFontStyle(pdc_ttffont, styles[i].font);
+        fontstyle = styles[i].font;
+    }
+#endif
+
+    if (SP->mono)
+        return;
+
+    if (newfg != foregr)
+    {
 #ifndef PDC_WIDE
-            SDL_SetPaletteColors(pdc_font->format->palette,
-                                 pdc_color + newfg, pdc_flastc, 1);
+        SDL_SetPaletteColors(pdc_font->format->palette,
+                             &styles[i].fgc, pdc_flastc, 1);
 #endif
-            foregr = newfg;
-        }
+        foregr = newfg;
+        fgcolor = styles[i].fgc;
+        fgmapped = styles[i].fgmap;
+    }
 
-        if (newbg != backgr)
-        {
+    if (newbg != backgr)
+    {
 #ifndef PDC_WIDE
-            if (newbg == -1)
-                SDL_SetColorKey(pdc_font, SDL_TRUE, 0);
-            else
-            {
-                if (backgr == -1)
-                    SDL_SetColorKey(pdc_font, SDL_FALSE, 0);
+        if (newbg == -1)
+            SDL_SetColorKey(pdc_font, SDL_TRUE, 0);
+        else
+        {
+            if (backgr == -1)
+                SDL_SetColorKey(pdc_font, SDL_FALSE, 0);
 
-                SDL_SetPaletteColors(pdc_font->format->palette,
-                                     pdc_color + newbg, 0, 1);
-            }
-#endif
-            backgr = newbg;
+            SDL_SetPaletteColors(pdc_font->format->palette,
+                                 &styles[i].bgc, 0, 1);
         }
-
-        oldch = ch;
+#endif
+        backgr = newbg;
+        bgmapped = styles[i].bgmap;
     }
 }
 
@@ -172,7 +274,7 @@ static void _set_attr(chtype ch)
 
 bool _grprint(chtype ch, SDL_Rect dest)
 {
-    Uint32 col = pdc_mapped[foregr];
+    Uint32 col = fgmapped;
     int hmid = (pdc_fheight - pdc_fthick) >> 1;
     int wmid = (pdc_fwidth - pdc_fthick) >> 1;
 
@@ -315,6 +417,7 @@ static int _col_to_pixel_x_draw(int row, int col)
 void PDC_gotoyx(int row, int col)
 {
     SDL_Rect src, dest;
+    const PDC_SIDE *side;
     chtype ch;
     int oldrow, oldcol;
 #ifdef PDC_WIDE
@@ -340,7 +443,8 @@ void PDC_gotoyx(int row, int col)
 
     ch = curscr->_y[row][col] ^ A_REVERSE;
 
-    _set_attr(ch);
+    side = PDC_SIDE_AT(curscr, row, col);
+    _set_attr(ch, PDC_CELL_PAIR(ch, side), side);
 
     src.h = (SP->visibility == 1) ? pdc_fheight >> 2 : pdc_fheight;
     src.w = pdc_fwidth;
@@ -351,7 +455,7 @@ void PDC_gotoyx(int row, int col)
     dest.w = src.w;
 
 #ifdef PDC_WIDE
-    SDL_FillRect(pdc_screen, &dest, pdc_mapped[backgr]);
+    SDL_FillRect(pdc_screen, &dest, bgmapped);
 
     if (!(SP->visibility == 2 && (ch & A_ALTCHARSET && !(ch & 0xff80)) &&
         _grprint(ch & (0x7f | A_ALTCHARSET), dest)))
@@ -362,7 +466,7 @@ void PDC_gotoyx(int row, int col)
         chstr[0] = ch & A_CHARTEXT;
 
         pdc_font = TTF_RenderUNICODE_Blended(pdc_ttffont, chstr,
-                                             pdc_color[foregr]);
+                                             fgcolor);
         if (pdc_font)
         {
             int center = pdc_fwidth > pdc_font->w ?
@@ -404,26 +508,29 @@ void PDC_gotoyx(int row, int col)
     }
 }
 
-void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
+void _new_packet(attr_t attr, int pair, const PDC_SIDE *side, int lineno,
+                 int x, int len, const chtype *srcp)
 {
-    SDL_Rect src, dest, lastrect;
+    SDL_Rect dest, lastrect;
     int j;
 #ifdef PDC_WIDE
     Uint16 chstr[2] = {0, 0};
+#else
+    SDL_Rect src;
 #endif
     attr_t sysattrs = SP->termattrs;
-    short hcol = SP->line_color;
+    Uint32 hcol;
     bool blink = blinked_off && (attr & A_BLINK) && (sysattrs & A_BLINK);
 
+    PDC_COUNT(packets, 1);
+
     if (rectcount == MAXRECT)
         PDC_update_rects();
 
-#ifdef PDC_WIDE
-    src.x = 0;
-    src.y = 0;
-#endif
+#ifndef PDC_WIDE
     src.h = pdc_fheight;
     src.w = pdc_fwidth;
+#endif
 
     dest.y = pdc_fheight * lineno + pdc_yoffset;
     dest.x = _col_to_pixel_x_draw(lineno, x);  /* Use draw version */
@@ -448,17 +555,16 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
     else
         uprect[rectcount++] = dest;
 
-    _set_attr(attr);
+    _set_attr(attr, pair, side);
 
     if (backgr == -1)
         SDL_BlitSurface(pdc_tileback, &dest, pdc_screen, &dest);
 #ifdef PDC_WIDE
     else
-        SDL_FillRect(pdc_screen, &dest, pdc_mapped[backgr]);
+        SDL_FillRect(pdc_screen, &dest, bgmapped);
 #endif
 
-    if (hcol == -1)
-        hcol = foregr;
+    hcol = (SP->line_color == -1) ? fgmapped : pdc_mapped[SP->line_color];
 
     for (j = 0; j < len; j++)
     {
@@ -504,7 +610,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
                         SDL_FreeSurface(pdc_font);
 
                     pdc_font = TTF_RenderUNICODE_Blended(pdc_ttffont, chstr,
-                                                         pdc_color[foregr]);
+                                                         fgcolor);
                 }
 
                 if (pdc_font)
@@ -515,7 +621,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
                         SDL_Rect wide_bg = dest;
                         wide_bg.w = pdc_fwidth * 2;
                         if (backgr != -1)
-                            SDL_FillRect(pdc_screen, &wide_bg, pdc_mapped[backgr]);
+                            SDL_FillRect(pdc_screen, &wide_bg, bgmapped);
                         SDL_BlitSurface(pdc_font, NULL, pdc_screen, &dest);
                     } else {
                         /* Narrow character: center within 1 cell */
@@ -540,12 +646,12 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
             dest.w = pdc_fthick;
 
             if (attr & A_LEFT)
-                SDL_FillRect(pdc_screen, &dest, pdc_mapped[hcol]);
+                SDL_FillRect(pdc_screen, &dest, hcol);
 
             if (attr & A_RIGHT)
             {
                 dest.x += pdc_fwidth - pdc_fthick;
-                SDL_FillRect(pdc_screen, &dest, pdc_mapped[hcol]);
+                SDL_FillRect(pdc_screen, &dest, hcol);
                 dest.x -= pdc_fwidth - pdc_fthick;
             }
         }
@@ -568,7 +674,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
         dest.h = pdc_fthick;
         dest.w = pdc_fwidth * len;
 
-        SDL_FillRect(pdc_screen, &dest, pdc_mapped[hcol]);
+        SDL_FillRect(pdc_screen, &dest, hcol);
     }
 }
 
@@ -577,34 +683,42 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
 
 void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
 {
+    const PDC_SIDE *side = PDC_SIDE_AT(curscr, lineno, x);
     attr_t old_attr, attr;
-    int i, j;
+    int i, j, old_pair, pair;
 
     PDC_LOG(("PDC_transform_line() - called: lineno=%d\n", lineno));
 
     old_attr = *srcp & (A_ATTRIBUTES ^ A_ALTCHARSET);
+    old_pair = PDC_CELL_PAIR(*srcp, side);
 
     for (i = 1, j = 1; j < len; i++, j++)
     {
         attr = srcp[i] & (A_ATTRIBUTES ^ A_ALTCHARSET);
+        pair = PDC_CELL_PAIR(srcp[i], side ? side + i : NULL);
 
-        if (attr != old_attr)
+        if (attr != old_attr || pair != old_pair || (side &&
+            (side[i].f != side->f || side[i].b != side->b)))
         {
-            _new_packet(old_attr, lineno, x, i, srcp);
+            _new_packet(old_attr, old_pair, side, lineno, x, i, srcp);
             old_attr = attr;
+            old_pair = pair;
             srcp += i;
+            if (side)
+                side += i;
             x += i;
             i = 0;
         }
     }
 
-    _new_packet(old_attr, lineno, x, i, srcp);
+    _new_packet(old_attr, old_pair, side, lineno, x, i, srcp);
 }
 
 static Uint32 _blink_timer(Uint32 interval, void *param)
 {
     SDL_Event event;
 
+    SDL_zero(event);
     event.type = SDL_USEREVENT;
     SDL_PushEvent(&event);
     return(interval);
@@ -615,8 +729,6 @@ void PDC_blink_text(void)
     static SDL_TimerID blinker_id = 0;
     int i, j, k;
 
-    oldch = (chtype)(-1);
-
     if (!(SP->termattrs & A_BLINK))
     {
         SDL_RemoveTimer(blinker_id);
@@ -645,8 +757,6 @@ void PDC_blink_text(void)
             }
     }
 
-    oldch = (chtype)(-1);
-
     PDC_doupdate();
 }
 
@@ -668,9 +778,6 @@ static void _render_composition_overlay(void)
         /* Clear previous composition area if it was larger */
         if (last_composition_width > 0)
         {
-            int last_base_x = _col_to_pixel_x_cursor(last_cursor_y, last_cursor_x);  /* Use cursor version */
-            int last_base_y = last_cursor_y * pdc_fheight + pdc_yoffset;
-
             /* Restore the area by redrawing from curscr */
             int start_col = last_cursor_x;
             int num_cols = (last_composition_width + pdc_fwidth - 1) / pdc_fwidth + 1;
@@ -729,6 +836,56 @@ static void _render_composition_overlay(void)
 #endif
 }
 
+/* move a block of cells within the window surface; rows are copied in
+   an order that's safe for overlapping blocks */
+
+bool PDC_copy_area(int y, int x, int nlines, int ncols, int toy, int tox)
+{
+    SDL_Rect dest;
+    Uint8 *from, *to;
+    int i, bpp, pitch, len, rows;
+
+    PDC_LOG(("PDC_copy_area() - called: y %d x %d to %d %d\n",
+             y, x, toy, tox));
+
+    if (SDL_MUSTLOCK(pdc_screen) && SDL_LockSurface(pdc_screen) < 0)
+        return FALSE;
+
+    bpp = pdc_screen->format->BytesPerPixel;
+    pitch = pdc_screen->pitch;
+    len = ncols * pdc_fwidth * bpp;
+    rows = nlines * pdc_fheight;
+
+    from = (Uint8 *)pdc_screen->pixels +
+           (y * pdc_fheight + pdc_yoffset) * pitch +
+           (x * pdc_fwidth + pdc_xoffset) * bpp;
+    to = (Uint8 *)pdc_screen->pixels +
+         (toy * pdc_fheight + pdc_yoffset) * pitch +
+         (tox * pdc_fwidth + pdc_xoffset) * bpp;
+
+    if (toy > y)
+        for (i = rows - 1; i >= 0; i--)
+            memmove(to + i * pitch, from + i * pitch, len);
+    else
+        for (i = 0; i < rows; i++)
+            memmove(to + i * pitch, from + i * pitch, len);
+
+    if (SDL_MUSTLOCK(pdc_screen))
+        SDL_UnlockSurface(pdc_screen);
+
+    dest.x = tox * pdc_fwidth + pdc_xoffset;
+    dest.y = toy * pdc_fheight + pdc_yoffset;
+    dest.w = ncols * pdc_fwidth;
+    dest.h = nlines * pdc_fheight;
+
+    if (rectcount == MAXRECT)
+        PDC_update_rects();
+
+    uprect[rectcount++] = dest;
+
+    return TRUE;
+}
+
 void PDC_doupdate(void)
 {
     static int window_shown = 0;
@@ -753,17 +910,21 @@ void PDC_pump_and_peep(void)
 {
     SDL_Event event;
 
-    if (SDL_PollEvent(&event))
+    /* look at the next event in place; pushing it back would put it
+       behind any others, out of order */
+
+    SDL_PumpEvents();
+
+    if (SDL_PeepEvents(&event, 1, SDL_PEEKEVENT, SDL_FIRSTEVENT,
+                       SDL_LASTEVENT) == 1 &&
+        SDL_WINDOWEVENT == event.type &&
+        (SDL_WINDOWEVENT_RESTORED == event.window.event ||
+         SDL_WINDOWEVENT_EXPOSED == event.window.event ||
+         SDL_WINDOWEVENT_SHOWN == event.window.event))
     {
-        if (SDL_WINDOWEVENT == event.type &&
-            (SDL_WINDOWEVENT_RESTORED == event.window.event ||
-             SDL_WINDOWEVENT_EXPOSED == event.window.event ||
-             SDL_WINDOWEVENT_SHOWN == event.window.event))
-        {
-            SDL_UpdateWindowSurface(pdc_window);
-            rectcount = 0;
-        }
-        else
-            SDL_PushEvent(&event);
+        SDL_PeepEvents(&event, 1, SDL_GETEVENT, SDL_WINDOWEVENT,
+                       SDL_WINDOWEVENT);
+        SDL_UpdateWindowSurface(pdc_window);
+        rectcount = 0;
     }
 }
@@ -3,12 +3,29 @@
 #include "pdcsdl.h"
 
 #include <ctype.h>
+#include <stdlib.h>
 #include <string.h>
 
 static SDL_Event event;
+static bool unread = FALSE;     /* event is yet to be handled */
 static SDL_Keycode oldkey;
 static MOUSE_STATUS old_mouse_status;
 
+/* A button press is held back for up to SP->mouse_wait ms, to see if
+   it's a click. If its release comes first, that's reported as
+   BUTTON_CLICKED, or BUTTON_DOUBLE_CLICKED for a second click that
+   follows within the same interval; otherwise, the press is reported
+   when the time is up, or when other input arrives. */
+
+static struct
+{
+    Uint8 button;           /* button of the held press, or 0 */
+    Uint32 time;            /* when it was pressed */
+    MOUSE_STATUS status;    /* to report if it's not a click */
+    Uint8 last;             /* button of the last click, or 0 */
+    Uint32 last_time;       /* when that click was released */
+} click;
+
 /* IME composition text storage */
 char pdc_composition_text[256] = "";
 int pdc_composition_cursor = 0;
@@ -81,23 +98,129 @@ void PDC_set_keyboard_binary(bool on)
     PDC_LOG(("PDC_set_keyboard_binary() - called\n"));
 }
 
+static bool _click_due(void)
+{
+    return click.button &&
+           SDL_GetTicks() - click.time >= (Uint32)SP->mouse_wait;
+}
+
+/* limit a wait of ms (-1 for no limit) to when the held press is due */
+
+static int _click_slice(int ms)
+{
+    if (click.button)
+    {
+        int due = max(SP->mouse_wait - (int)(SDL_GetTicks() - click.time),
+                      0);
+
+        if (ms < 0 || ms > due)
+            ms = due;
+    }
+
+    return ms;
+}
+
+/* whether the press can still be held after the unread event: yes for
+   its release, motion within its cell, and anything that isn't input */
+
+static bool _click_holds(void)
+{
+    switch (event.type)
+    {
+    case SDL_MOUSEBUTTONUP:
+        return event.button.button == click.button;
+    case SDL_MOUSEMOTION:
+        return (event.motion.x - pdc_xoffset) / pdc_fwidth ==
+                   click.status.x &&
+               (event.motion.y - pdc_yoffset) / pdc_fheight ==
+                   click.status.y;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEWHEEL:
+    case SDL_KEYUP:
+    case SDL_KEYDOWN:
+    case SDL_TEXTINPUT:
+    case SDL_TEXTEDITING:
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 /* check if a key or mouse event is waiting */
 
 bool PDC_check_key(void)
 {
-    int haveevent;
+    if (!unread)
+    {
+        PDC_pump_and_peep();
+
+        /* SDL_TEXTINPUT can return multiple chars from the IME which we
+           should handle before polling for additional events. */
+
+        if (event.type == SDL_TEXTINPUT && event.text.text[0])
+            unread = TRUE;
+        else
+            unread = SDL_PollEvent(&event);
+    }
 
-    PDC_pump_and_peep();
+    return unread || _click_due();
+}
 
-    /* SDL_TEXTINPUT can return multiple chars from the IME which we
-       should handle before polling for additional events. */
+/* PDC_wakeup() pushes an SDL_USEREVENT with this code, once the first
+   wait has started; keys posted before then are seen when the wait
+   starts. It's otherwise ignored. (The blink timer's events, also
+   SDL_USEREVENTs, have code 0.) */
 
-    if (event.type == SDL_TEXTINPUT && event.text.text[0])
-        haveevent = 1;
-    else
-        haveevent = SDL_PollEvent(&event);
+#define WAKE_CODE 1
+
+static bool wake_ready = FALSE;
+
+void PDC_wakeup(void)
+{
+    SDL_Event wake;
+
+    if (wake_ready)
+    {
+        SDL_zero(wake);
+        wake.type = SDL_USEREVENT;
+        wake.user.code = WAKE_CODE;
+        SDL_PushEvent(&wake);
+    }
+}
+
+/* sleep until there's an event, or *ms have passed */
+
+bool PDC_wait_key(int *ms)
+{
+    Uint32 start = SDL_GetTicks();
+    int left = *ms;
+
+    PDC_LOG(("PDC_wait_key() - called: ms=%d\n", *ms));
+
+    wake_ready = TRUE;
+
+    for (;;)
+    {
+        bool ready = PDC_key_posted() || PDC_check_key();
+
+        if (*ms >= 0)
+            left = max(*ms - (int)(SDL_GetTicks() - start), 0);
+
+        if (ready)
+            break;
+
+        if (!left)
+            return FALSE;
 
-    return haveevent;
+        if (_click_slice(left) < 0)
+            SDL_WaitEvent(NULL);
+        else
+            SDL_WaitEventTimeout(NULL, _click_slice(left));
+    }
+
+    *ms = left;
+
+    return TRUE;
 }
 
 #ifdef PDC_WIDE
@@ -320,12 +443,62 @@ static int _process_key_event(void)
     return -1;
 }
 
-static int _process_mouse_event(void)
+static int _wheel_changes(const SDL_Event *ev)
+{
+    if (ev->wheel.y > 0)
+        return PDC_MOUSE_WHEEL_UP;
+    if (ev->wheel.y < 0)
+        return PDC_MOUSE_WHEEL_DOWN;
+    if (ev->wheel.x > 0)
+        return PDC_MOUSE_WHEEL_RIGHT;
+    if (ev->wheel.x < 0)
+        return PDC_MOUSE_WHEEL_LEFT;
+
+    return 0;
+}
+
+/* merge any motion events with the same buttons held, or wheel events
+   in the same direction, queued up right behind this one; return how
+   many events there were in all */
+
+static int _coalesce(void)
+{
+    SDL_Event next;
+    int count = 1;
+
+    if (event.type != SDL_MOUSEMOTION && event.type != SDL_MOUSEWHEEL)
+        return count;
+
+    while (SDL_PeepEvents(&next, 1, SDL_PEEKEVENT, SDL_FIRSTEVENT,
+                          SDL_LASTEVENT) == 1 && next.type == event.type)
+    {
+        if (event.type == SDL_MOUSEMOTION ?
+            next.motion.state != event.motion.state :
+            _wheel_changes(&next) != _wheel_changes(&event))
+            break;
+
+        SDL_PeepEvents(&next, 1, SDL_GETEVENT, next.type, next.type);
+
+        if (event.type == SDL_MOUSEWHEEL)
+        {
+            next.wheel.x += event.wheel.x;
+            next.wheel.y += event.wheel.y;
+        }
+
+        event = next;
+        count++;
+    }
+
+    return count;
+}
+
+static int _process_mouse_event(int count)
 {
     SDL_Keymod keymods;
     short shift_flags = 0;
 
     memset(&SP->mouse_status, 0, sizeof(MOUSE_STATUS));
+    SP->mouse_count = count;
 
     keymods = SDL_GetModState();
 
@@ -369,53 +542,68 @@ static int _process_mouse_event(void)
         SP->mouse_status.x = (x - pdc_xoffset) / pdc_fwidth;
         SP->mouse_status.y = (y - pdc_yoffset) / pdc_fheight;
 
-        if (event.wheel.y > 0)
-            SP->mouse_status.changes = PDC_MOUSE_WHEEL_UP;
-        else if (event.wheel.y < 0)
-            SP->mouse_status.changes = PDC_MOUSE_WHEEL_DOWN;
-        else if (event.wheel.x > 0)
-            SP->mouse_status.changes = PDC_MOUSE_WHEEL_RIGHT;
-        else if (event.wheel.x < 0)
-            SP->mouse_status.changes = PDC_MOUSE_WHEEL_LEFT;
-        else
+        SP->mouse_status.changes = _wheel_changes(&event);
+
+        if (!SP->mouse_status.changes)
             return -1;
 
+        /* count the steps, which may be more than one per event */
+
+        count = event.wheel.y ? event.wheel.y : event.wheel.x;
+        SP->mouse_count = (count < 0) ? -count : count;
+
         SP->key_code = TRUE;
         return KEY_MOUSE;
     }
     else
     {
-        short action = (event.button.state == SDL_PRESSED) ?
-                       BUTTON_PRESSED : BUTTON_RELEASED;
+        short action = BUTTON_PRESSED;
         Uint8 btn = event.button.button;
 
         if (btn < 1 || btn > 3)
             return -1;
 
-        /* check for a click -- a press followed immediately by a release */
+        /* the release of a held press is a click; a second one in a row
+           is a double click, if those are wanted */
 
-        if (action == BUTTON_PRESSED && SP->mouse_wait)
+        if (event.button.state != SDL_PRESSED)
         {
-            SDL_Event rel;
+            action = BUTTON_RELEASED;
 
-            napms(SP->mouse_wait);
-
-            if (SDL_PollEvent(&rel))
+            if (btn == click.button)
             {
-                if (rel.type == SDL_MOUSEBUTTONUP && rel.button.button == btn)
-                    action = BUTTON_CLICKED;
+                action = BUTTON_CLICKED;
+
+                if (btn == click.last && (SP->_trap_mbe &
+                    (BUTTON1_DOUBLE_CLICKED << ((btn - 1) * 5))) &&
+                    click.time - click.last_time <= (Uint32)SP->mouse_wait)
+                {
+                    action = BUTTON_DOUBLE_CLICKED;
+                    click.last = 0;
+                }
                 else
-                    SDL_PushEvent(&rel);
+                {
+                    click.last = btn;
+                    click.last_time = event.button.timestamp;
+                }
+
+                click.button = 0;
             }
         }
 
         SP->mouse_status.x = (event.button.x - pdc_xoffset) / pdc_fwidth;
         SP->mouse_status.y = (event.button.y - pdc_yoffset) / pdc_fheight;
 
-        btn--;
+        SP->mouse_status.button[btn - 1] = action | shift_flags;
+        SP->mouse_status.changes = (1 << (btn - 1));
 
-        SP->mouse_status.button[btn] = action | shift_flags;
-        SP->mouse_status.changes = (1 << btn);
+        if (action == BUTTON_PRESSED && SP->mouse_wait)
+        {
+            click.button = btn;
+            click.time = event.button.timestamp;
+            click.status = SP->mouse_status;
+            return -1;
+        }
     }
 
     old_mouse_status = SP->mouse_status;
@@ -424,10 +612,44 @@ static int _process_mouse_event(void)
     return KEY_MOUSE;
 }
 
+/* convert an SDL event time to PDC_us_count() time, for the latency */
+
+static unsigned long _stamp(Uint32 ticks)
+{
+    return PDC_us_count() - (unsigned long)(SDL_GetTicks() - ticks) * 1000;
+}
+
 /* return the next available key or mouse event */
 
 int PDC_get_key(void)
 {
+    /* report a held press that's not going to be a click */
+
+    if (click.button && (_click_due() || (unread && !_click_holds())))
+    {
+        SP->mouse_status = old_mouse_status = click.status;
+        SP->mouse_count = 1;
+        SP->key_time = _stamp(click.time);
+        click.button = 0;
+
+        SP->key_code = TRUE;
+        return KEY_MOUSE;
+    }
+
+    if (!unread)
+        return -1;
+
+    unread = FALSE;
+    SP->key_time = _stamp(event.common.timestamp);
+
+    PDC_TRACE((PDC_EV_INPUT, event.type, (event.type == SDL_KEYDOWN ||
+               event.type == SDL_KEYUP) ? event.key.keysym.sym : 0, 0));
+
+    /* drop motion within the cell of a held press */
+
+    if (click.button && event.type == SDL_MOUSEMOTION)
+        return -1;
+
     switch (event.type)
     {
     case SDL_QUIT:
@@ -459,7 +681,7 @@ int PDC_get_key(void)
     case SDL_MOUSEBUTTONDOWN:
     case SDL_MOUSEWHEEL:
         oldkey = SDLK_SPACE;
-        return _process_mouse_event();
+        return _process_mouse_event(_coalesce());
     case SDL_KEYUP:
     case SDL_KEYDOWN:
     case SDL_TEXTINPUT:
@@ -467,7 +689,8 @@ int PDC_get_key(void)
         PDC_mouse_set();
         return _process_key_event();
     case SDL_USEREVENT:
-        PDC_blink_text();
+        if (event.user.code != WAKE_CODE)
+            PDC_blink_text();
     }
 
     return -1;
@@ -482,6 +705,8 @@ void PDC_flushinp(void)
 
     while (PDC_check_key())
         PDC_get_key();
+
+    click.button = 0;
 }
 
 bool PDC_has_mouse(void)
@@ -129,6 +129,8 @@ static void _initialize_colors(void)
     for (i = 0; i < 256; i++)
         pdc_mapped[i] = SDL_MapRGB(pdc_screen->format, pdc_color[i].r,
                                    pdc_color[i].g, pdc_color[i].b);
+
+    PDC_reset_styles();
 }
 
 /* find the display where the mouse pointer is */
@@ -358,6 +360,7 @@ int PDC_scr_open(void)
 #ifdef PDC_WIDE
     SP->termattrs |= A_ITALIC;
 #endif
+    SP->rgb_color = TRUE;
 
     PDC_reset_prog_mode();
 
@@ -503,5 +506,7 @@ int PDC_init_color(short color, short red, short green, short blue)
     pdc_mapped[color] = SDL_MapRGB(pdc_screen->format, pdc_color[color].r,
                                    pdc_color[color].g, pdc_color[color].b);
 
+    PDC_reset_styles();
+
     return OK;
 }
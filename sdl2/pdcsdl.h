@@ -38,3 +38,4 @@ PDCEX  void PDC_retile(void);
 
 extern void PDC_pump_and_peep(void);
 extern void PDC_blink_text(void);
+extern void PDC_reset_styles(void);
@@ -75,6 +75,7 @@ int PDC_set_blink(bool blinkon)
         if (!(SP->termattrs & A_BLINK))
         {
             SP->termattrs |= A_BLINK;
+            PDC_reset_styles();
             PDC_blink_text();
         }
     }
@@ -83,6 +84,7 @@ int PDC_set_blink(bool blinkon)
         if (SP->termattrs & A_BLINK)
         {
             SP->termattrs &= ~A_BLINK;
+            PDC_reset_styles();
             PDC_blink_text();
         }
     }
@@ -101,6 +103,8 @@ int PDC_set_bold(bool boldon)
     else
         SP->termattrs &= ~A_BOLD;
 
+    PDC_reset_styles();
+
     return OK;
 #else
     return boldon ? ERR : OK;
@@ -7,6 +7,20 @@ void PDC_beep(void)
     PDC_LOG(("PDC_beep() - called\n"));
 }
 
+unsigned long PDC_ms_count(void)
+{
+    return SDL_GetTicks();
+}
+
+unsigned long PDC_us_count(void)
+{
+    Uint64 count = SDL_GetPerformanceCounter();
+    Uint64 freq = SDL_GetPerformanceFrequency();
+
+    return (unsigned long)(count / freq * 1000000 +
+                           count % freq * 1000000 / freq);
+}
+
 void PDC_napms(int ms)
 {
     PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
@@ -136,24 +136,27 @@ void _set_ansi_color(short f, short b, attr_t attr)
     }
 }
 
-void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
+void _new_packet(attr_t attr, int pair, int lineno, int x, int len,
+                 const chtype *srcp)
 {
     int j;
     short fore, back;
     bool blink, ansi;
 
+    PDC_COUNT(packets, 1);
+
     if (pdc_ansi && (lineno == (SP->lines - 1)) && ((x + len) == SP->cols))
     {
         len--;
         if (len)
-            _new_packet(attr, lineno, x, len, srcp);
+            _new_packet(attr, pair, lineno, x, len, srcp);
         pdc_ansi = FALSE;
-        _new_packet(attr, lineno, x + len, 1, srcp + len);
+        _new_packet(attr, pair, lineno, x + len, 1, srcp + len);
         pdc_ansi = TRUE;
         return;
     }
 
-    pair_content(PAIR_NUMBER(attr), &fore, &back);
+    pair_content(pair, &fore, &back);
     ansi = pdc_ansi || (fore >= 16 || back >= 16);
     blink = (SP->termattrs & A_BLINK) && (attr & A_BLINK);
 
@@ -256,28 +259,34 @@ NONANSI:
 
 void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
 {
+    const PDC_SIDE *side = PDC_SIDE_AT(curscr, lineno, x);
     attr_t old_attr, attr;
-    int i, j;
+    int i, j, old_pair, pair;
 
     PDC_LOG(("PDC_transform_line() - called: lineno=%d\n", lineno));
 
     old_attr = *srcp & (A_ATTRIBUTES ^ A_ALTCHARSET);
+    old_pair = PDC_CELL_PAIR(*srcp, side);
 
     for (i = 1, j = 1; j < len; i++, j++)
     {
         attr = srcp[i] & (A_ATTRIBUTES ^ A_ALTCHARSET);
+        pair = PDC_CELL_PAIR(srcp[i], side ? side + i : NULL);
 
-        if (attr != old_attr)
+        if (attr != old_attr || pair != old_pair)
         {
-            _new_packet(old_attr, lineno, x, i, srcp);
+            _new_packet(old_attr, old_pair, lineno, x, i, srcp);
             old_attr = attr;
+            old_pair = pair;
             srcp += i;
+            if (side)
+                side += i;
             x += i;
             i = 0;
         }
     }
 
-    _new_packet(old_attr, lineno, x, i, srcp);
+    _new_packet(old_attr, old_pair, lineno, x, i, srcp);
 }
 
 void PDC_blink_text(void)
@@ -324,6 +333,37 @@ void PDC_blink_text(void)
     pdc_last_blink = GetTickCount();
 }
 
+bool PDC_copy_area(int y, int x, int nlines, int ncols, int toy, int tox)
+{
+    SMALL_RECT src, clip;
+    COORD dest;
+    CHAR_INFO fill;
+
+    PDC_LOG(("PDC_copy_area() - called: y %d x %d to %d %d\n",
+             y, x, toy, tox));
+
+    src.Top = y;
+    src.Left = x;
+    src.Bottom = y + nlines - 1;
+    src.Right = x + ncols - 1;
+
+    /* clip to the destination, so the vacated cells aren't filled */
+
+    clip.Top = toy;
+    clip.Left = tox;
+    clip.Bottom = toy + nlines - 1;
+    clip.Right = tox + ncols - 1;
+
+    dest.X = tox;
+    dest.Y = toy;
+
+    fill.Char.UnicodeChar = ' ';
+    fill.Attributes = 0;
+
+    return ScrollConsoleScreenBuffer(pdc_con_out, &src, &clip, dest, &fill)
+           ? TRUE : FALSE;
+}
+
 void PDC_doupdate(void)
 {
 }
@@ -266,6 +266,71 @@ bool PDC_check_key(void)
     return (event_count != 0);
 }
 
+/* PDC_wakeup() sets this event, made on the first wait; keys posted
+   before then are seen when the wait starts */
+
+static HANDLE wake_event = NULL;
+
+void PDC_wakeup(void)
+{
+    if (wake_event)
+        SetEvent(wake_event);
+}
+
+/* sleep until there's an event, or *ms have passed, blinking the text
+   as needed */
+
+bool PDC_wait_key(int *ms)
+{
+    DWORD start = GetTickCount();
+    DWORD wait;
+    HANDLE handles[2];
+    int left = *ms;
+
+    PDC_LOG(("PDC_wait_key() - called: ms=%d\n", *ms));
+
+    if (!wake_event)
+        wake_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+    handles[0] = pdc_con_in;
+    handles[1] = wake_event;
+
+    for (;;)
+    {
+        bool ready = PDC_key_posted() || PDC_check_key();
+
+        if (*ms >= 0)
+            left = max(*ms - (int)(GetTickCount() - start), 0);
+
+        if (ready)
+            break;
+
+        if (!left)
+            return FALSE;
+
+        wait = (left < 0) ? INFINITE : (DWORD)left;
+
+        if (SP->termattrs & A_BLINK)
+        {
+            DWORD since = GetTickCount() - pdc_last_blink;
+
+            if (since >= 500)
+            {
+                PDC_blink_text();
+                since = 0;
+            }
+
+            wait = min(wait, 500 - since);
+        }
+
+        WaitForMultipleObjects(wake_event ? 2 : 1, handles, FALSE, wait);
+    }
+
+    *ms = left;
+
+    return TRUE;
+}
+
 /* _get_key_count returns 0 if save_ip doesn't contain an event which
    should be passed back to the user. This function filters "useless"
    events.
@@ -629,6 +694,10 @@ int PDC_get_key(void)
     {
         key_count--;
 
+        PDC_TRACE((PDC_EV_INPUT, save_ip.EventType,
+                   (save_ip.EventType == KEY_EVENT) ?
+                   KEV.wVirtualKeyCode : 0, 0));
+
         switch (save_ip.EventType)
         {
         case KEY_EVENT:
@@ -10,6 +10,24 @@ void PDC_beep(void)
     MessageBeep(0XFFFFFFFF);
 }
 
+unsigned long PDC_ms_count(void)
+{
+    return GetTickCount();
+}
+
+unsigned long PDC_us_count(void)
+{
+    LARGE_INTEGER count, freq;
+
+    if (!QueryPerformanceFrequency(&freq) ||
+        !QueryPerformanceCounter(&count))
+        return GetTickCount() * 1000UL;
+
+    return (unsigned long)(count.QuadPart / freq.QuadPart * 1000000 +
+                           count.QuadPart % freq.QuadPart * 1000000 /
+                           freq.QuadPart);
+}
+
 void PDC_napms(int ms)
 {
     PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
@@ -58,16 +58,14 @@ static void _make_xy(int x, int y, int *xpos, int *ypos)
     *ypos = pdc_app_data.normalFont->ascent + (y * pdc_fheight);
 }
 
-static void _set_cursor_color(chtype *ch, short *fore, short *back)
+static void _set_cursor_color(chtype *ch, int pair, short *fore,
+                              short *back)
 {
-    int attr;
     short f, b;
 
-    attr = PAIR_NUMBER(*ch);
-
-    if (attr)
+    if (pair)
     {
-        pair_content(attr, &f, &b);
+        pair_content(pair, &f, &b);
         *fore = 7 - (f % 8);
         *back = 7 - (b % 8);
     }
@@ -88,7 +86,7 @@ static void _set_cursor_color(chtype *ch, short *fore, short *back)
 
 static void _display_cursor(int old_row, int old_x, int new_row, int new_x)
 {
-    int xpos, ypos, i;
+    int xpos, ypos, i, pair;
     chtype *ch;
     short fore = 0, back = 0;
 
@@ -117,7 +115,8 @@ static void _display_cursor(int old_row, int old_x, int new_row, int new_x)
     _make_xy(new_x, new_row, &xpos, &ypos);
 
     ch = curscr->_y[new_row] + new_x;
-    _set_cursor_color(ch, &fore, &back);
+    pair = PDC_CELL_PAIR(*ch, PDC_SIDE_AT(curscr, new_row, new_x));
+    _set_cursor_color(ch, pair, &fore, &back);
 
     if (pdc_vertical_cursor)
     {
@@ -261,26 +260,51 @@ void PDC_gotoyx(int row, int col)
     PDC_display_cursor(SP->cursrow, SP->curscol, row, col, SP->visibility);
 }
 
-/* update the given physical line to look like the corresponding line in
-   curscr */
+/* Resolved drawing styles, for the A_BOLD, A_BLINK, A_REVERSE and
+   A_ITALIC bits of the attribute, in a table mapped directly from the
+   pair's low bits. An entry holds while its pair and gen match, and
+   its count matches the pair's, which changes whenever the pair does;
+   PDC_reset_styles() drops them all. Cells with direct colors from the
+   side plane aren't cached; they share the extra entry at RGB_STYLE. */
 
-/* Output a block of characters with common attributes */
+#define RGB_STYLE (PDC_COLOR_PAIRS << 4)
 
-static int _new_packet(chtype attr, int len, int col, int row,
-#ifdef PDC_WIDE
-                       XChar2b *text)
-#else
-                       char *text)
-#endif
+static struct
 {
-    XRectangle bounds;
+    int pair, gen, count;
+    int fore, back;       /* colors, after bold and blink */
+    Pixel fg, bg;         /* pixels to draw with, after reverse */
     GC gc;
-    int xpos, ypos;
-    short fore, back;
+} styles[RGB_STYLE + 1];
+
+static int style_gen = 1;
+
+/* PDC_RGB_COLOR() values are pixels already, as PDC_has_rgb_color() is
+   only set for a 24-bit TrueColor visual */
+
+static Pixel _pixel(int color)
+{
+    return PDC_IS_RGB(color) ? (Pixel)(color & 0xffffff) : pdc_color[color];
+}
+
+void PDC_reset_styles(void)
+{
+    style_gen++;
+}
+
+static int _get_style(chtype attr, int pair, const PDC_SIDE *side)
+{
+    bool rgb = PDC_SIDE_RGB(side);
+    int i = rgb ? RGB_STYLE : ((pair & (PDC_COLOR_PAIRS - 1)) << 4) |
+            ((attr >> 20) & 0x0e) | ((attr >> 19) & 1);
+    int fore, back;
     attr_t sysattrs;
-    bool rev;
 
-    pair_content(PAIR_NUMBER(attr), &fore, &back);
+    if (!rgb && styles[i].pair == pair && styles[i].gen == style_gen &&
+        styles[i].count == SP->atrtab[pair].count)
+        return i;
+
+    extended_pair_content(pair, &fore, &back);
 
     /* Specify the color table offsets */
 
@@ -291,16 +315,65 @@ static int _new_packet(chtype attr, int len, int col, int row,
     if ((attr & A_BLINK) && !(sysattrs & A_BLINK))
         back |= 8;
 
-    rev = !!(attr & A_REVERSE);
+    if (rgb)
+    {
+        if (side->f)
+            fore = side->f;
+        if (side->b)
+            back = side->b;
+    }
+
+    styles[i].fore = fore;
+    styles[i].back = back;
+
+    if (attr & A_REVERSE)
+    {
+        styles[i].fg = _pixel(back);
+        styles[i].bg = _pixel(fore);
+    }
+    else
+    {
+        styles[i].fg = _pixel(fore);
+        styles[i].bg = _pixel(back);
+    }
 
     /* Determine which GC to use - normal, italic or bold */
 
     if ((attr & A_ITALIC) && (sysattrs & A_ITALIC))
-        gc = pdc_italic_gc;
+        styles[i].gc = pdc_italic_gc;
     else if ((attr & A_BOLD) && (sysattrs & A_BOLD))
-        gc = pdc_bold_gc;
+        styles[i].gc = pdc_bold_gc;
     else
-        gc = pdc_normal_gc;
+        styles[i].gc = pdc_normal_gc;
+
+    styles[i].pair = pair;
+    styles[i].gen = style_gen;
+    styles[i].count = SP->atrtab[pair].count;
+
+    return i;
+}
+
+/* update the given physical line to look like the corresponding line in
+   curscr */
+
+/* Output a block of characters with common attributes */
+
+static int _new_packet(chtype attr, int pair, const PDC_SIDE *side,
+                       int len, int col, int row,
+#ifdef PDC_WIDE
+                       XChar2b *text)
+#else
+                       char *text)
+#endif
+{
+    XRectangle bounds;
+    GC gc;
+    int xpos, ypos, style;
+
+    PDC_COUNT(packets, 1);
+
+    style = _get_style(attr, pair, side);
+    gc = styles[style].gc;
 
     _make_xy(col, row, &xpos, &ypos);
 
@@ -311,9 +384,9 @@ static int _new_packet(chtype attr, int len, int col, int row,
 
     XSetClipRectangles(XCURSESDISPLAY, gc, 0, 0, &bounds, 1, Unsorted);
 
-    if (pdc_blinked_off && (sysattrs & A_BLINK) && (attr & A_BLINK))
+    if (pdc_blinked_off && (SP->termattrs & A_BLINK) && (attr & A_BLINK))
     {
-        XSetForeground(XCURSESDISPLAY, gc, pdc_color[rev ? fore : back]);
+        XSetForeground(XCURSESDISPLAY, gc, styles[style].bg);
         XFillRectangle(XCURSESDISPLAY, XCURSESWIN, gc, xpos, bounds.y,
                        bounds.width, pdc_fheight);
     }
@@ -321,8 +394,8 @@ static int _new_packet(chtype attr, int len, int col, int row,
     {
         /* Draw it */
 
-        XSetForeground(XCURSESDISPLAY, gc, pdc_color[rev ? back : fore]);
-        XSetBackground(XCURSESDISPLAY, gc, pdc_color[rev ? fore : back]);
+        XSetForeground(XCURSESDISPLAY, gc, styles[style].fg);
+        XSetBackground(XCURSESDISPLAY, gc, styles[style].bg);
 
 #ifdef PDC_WIDE
         XDrawImageString16(
@@ -364,7 +437,7 @@ static int _new_packet(chtype attr, int len, int col, int row,
 
     PDC_LOG(("_new_packet() - row: %d col: %d "
              "num_cols: %d fore: %d back: %d text:<%s>\n",
-             row, col, len, fore, back, text));
+             row, col, len, styles[style].fore, styles[style].back, text));
 
     return OK;
 }
@@ -378,8 +451,10 @@ void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
 #else
     char text[513];
 #endif
+    const PDC_SIDE *side = PDC_SIDE_AT(curscr, lineno, x);
+    const PDC_SIDE *old_side = side;
     chtype old_attr, attr;
-    int i, j;
+    int i, j, old_pair, pair;
 
     PDC_LOG(("PDC_transform_line() - called: lineno: %d x: %d "
              "len: %d\n", lineno, x, len));
@@ -388,12 +463,14 @@ void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
         return;
 
     old_attr = *srcp & A_ATTRIBUTES;
+    old_pair = PDC_CELL_PAIR(*srcp, side);
 
     for (i = 0, j = 0; j < len; j++)
     {
         chtype curr = srcp[j];
 
         attr = curr & A_ATTRIBUTES;
+        pair = PDC_CELL_PAIR(curr, side ? side + j : NULL);
 
         if (attr & A_ALTCHARSET && !(curr & 0xff80))
         {
@@ -410,12 +487,17 @@ void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
             attr ^= A_REVERSE;
         }
 #endif
-        if (attr != old_attr)
+        if (attr != old_attr || pair != old_pair || (side &&
+            (side[j].f != old_side->f || side[j].b != old_side->b)))
         {
-            if (_new_packet(old_attr, i, x, lineno, text) == ERR)
+            if (_new_packet(old_attr, old_pair, old_side, i, x, lineno,
+                            text) == ERR)
                 return;
 
             old_attr = attr;
+            old_pair = pair;
+            if (side)
+                old_side = side + j;
             x += i;
             i = 0;
         }
@@ -428,7 +510,24 @@ void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
 #endif
     }
 
-    _new_packet(old_attr, i, x, lineno, text);
+    _new_packet(old_attr, old_pair, old_side, i, x, lineno, text);
+}
+
+bool PDC_copy_area(int y, int x, int nlines, int ncols, int toy, int tox)
+{
+    PDC_LOG(("PDC_copy_area() - called: y %d x %d to %d %d\n",
+             y, x, toy, tox));
+
+    /* _new_packet() leaves a clip rectangle set on the GC */
+
+    XSetClipMask(XCURSESDISPLAY, pdc_normal_gc, None);
+
+    XCopyArea(XCURSESDISPLAY, XCURSESWIN, XCURSESWIN, pdc_normal_gc,
+              x * pdc_fwidth, y * pdc_fheight,
+              ncols * pdc_fwidth, nlines * pdc_fheight,
+              tox * pdc_fwidth, toy * pdc_fheight);
+
+    return TRUE;
 }
 
 void PDC_doupdate(void)
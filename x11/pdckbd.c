@@ -12,6 +12,14 @@
 # include <Sunkeysym.h>
 #endif
 
+#ifdef HAVE_POLL
+# include <poll.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 static struct
 {
     KeySym keycode;
@@ -334,7 +342,105 @@ static unsigned long _process_key_event(XEvent *event)
     return -1;
 }
 
-static unsigned long _process_mouse_event(XEvent *event)
+/* A button press is held back for up to SP->mouse_wait ms, to see if
+   it's a click. If its release comes first, that's reported as
+   BUTTON_CLICKED, or BUTTON_DOUBLE_CLICKED for a second click that
+   follows within the same interval; otherwise, the press is reported
+   when the time is up, or when other input arrives. */
+
+static struct
+{
+    int button;             /* button of the held press, or 0 */
+    unsigned long time;     /* when it was pressed */
+    unsigned long stamp;    /* the same, in us, for the latency */
+    MOUSE_STATUS status;    /* to report if it's not a click */
+    int last;               /* button of the last click, or 0 */
+    unsigned long last_time;    /* when that click was released */
+} click;
+
+static bool _click_due(void)
+{
+    return click.button &&
+           PDC_ms_count() - click.time >= (unsigned long)SP->mouse_wait;
+}
+
+/* limit a wait of ms (-1 for no limit) to when the held press is due */
+
+static int _click_slice(int ms)
+{
+    if (click.button)
+    {
+        int due = max(SP->mouse_wait - (int)(PDC_ms_count() - click.time), 0);
+
+        if (ms < 0 || ms > due)
+            ms = due;
+    }
+
+    return ms;
+}
+
+/* whether the press can still be held after this event: yes for its
+   release, motion within its cell, and anything that isn't input */
+
+static bool _click_holds(XEvent *event)
+{
+    switch (event->type)
+    {
+    case ButtonRelease:
+        return event->xbutton.button == click.button;
+    case MotionNotify:
+        return event->xmotion.x / pdc_fwidth == click.status.x &&
+               event->xmotion.y / pdc_fheight == click.status.y;
+    case ButtonPress:
+    case KeyPress:
+    case KeyRelease:
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* merge any motion events with the same buttons held, or wheel
+   presses of the same button (and their releases), queued up right
+   behind this one; return how many events there were in all */
+
+static int _coalesce(XEvent *event)
+{
+    XEvent next;
+    int count = 1;
+    bool wheel = event->type == ButtonPress &&
+                 event->xbutton.button >= 4 && event->xbutton.button <= 7;
+
+    if (event->type != MotionNotify && !wheel)
+        return count;
+
+    while (XEventsQueued(XCURSESDISPLAY, QueuedAfterReading))
+    {
+        XPeekEvent(XCURSESDISPLAY, &next);
+
+        /* releases of scroll buttons are ignored anyway */
+
+        if (wheel && next.type == ButtonRelease &&
+            next.xbutton.button == event->xbutton.button)
+        {
+            XNextEvent(XCURSESDISPLAY, &next);
+            continue;
+        }
+
+        if (next.type != event->type ||
+            next.xany.window != event->xany.window ||
+            next.xbutton.state != event->xbutton.state ||
+            (wheel && next.xbutton.button != event->xbutton.button))
+            break;
+
+        XNextEvent(XCURSESDISPLAY, event);
+        count++;
+    }
+
+    return count;
+}
+
+static unsigned long _process_mouse_event(XEvent *event, int count)
 {
     int button_no;
     static int last_button_no = 0;
@@ -342,6 +448,7 @@ static unsigned long _process_mouse_event(XEvent *event)
     PDC_LOG(("_process_mouse_event() - called\n"));
 
     keysym = 0; /* suppress any modifier key return */
+    SP->mouse_count = count;
 
     button_no = event->xbutton.button;
 
@@ -390,21 +497,6 @@ static unsigned long _process_mouse_event(XEvent *event)
         MOUSE_LOG(("\nButtonPress\n"));
 
         SP->mouse_status.button[button_no - 1] = BUTTON_PRESSED;
-
-        napms(SP->mouse_wait);
-        while (XtAppPending(pdc_app_context))
-        {
-            XEvent rel;
-            XtAppNextEvent(pdc_app_context, &rel);
-
-            if (rel.type == ButtonRelease && rel.xbutton.button == button_no)
-                SP->mouse_status.button[button_no - 1] = BUTTON_CLICKED;
-            else
-                XSendEvent(XtDisplay(pdc_toplevel),
-                           RootWindowOfScreen(XtScreen(pdc_toplevel)),
-                           True, 0, &rel);
-        }
-
         break;
 
     case MotionNotify:
@@ -426,6 +518,30 @@ static unsigned long _process_mouse_event(XEvent *event)
             return -1;
 
         SP->mouse_status.button[button_no - 1] = BUTTON_RELEASED;
+
+        /* the release of a held press is a click; a second one in a row
+           is a double click, if those are wanted */
+
+        if (button_no == click.button)
+        {
+            SP->mouse_status.button[button_no - 1] = BUTTON_CLICKED;
+
+            if (button_no == click.last && (SP->_trap_mbe &
+                (BUTTON1_DOUBLE_CLICKED << ((button_no - 1) * 5))) &&
+                click.time - click.last_time <= (unsigned long)SP->mouse_wait)
+            {
+                SP->mouse_status.button[button_no - 1] =
+                    BUTTON_DOUBLE_CLICKED;
+                click.last = 0;
+            }
+            else
+            {
+                click.last = button_no;
+                click.last_time = PDC_ms_count();
+            }
+
+            click.button = 0;
+        }
     }
 
     /* Set up the mouse status fields in preparation for sending */
@@ -451,6 +567,15 @@ static unsigned long _process_mouse_event(XEvent *event)
         SP->mouse_status.y < 0 || SP->mouse_status.y >= SP->lines)
         return -1;
 
+    if (event->type == ButtonPress && SP->mouse_wait)
+    {
+        click.button = button_no;
+        click.time = PDC_ms_count();
+        click.stamp = PDC_us_count();
+        click.status = SP->mouse_status;
+        return -1;
+    }
+
     /* Send the KEY_MOUSE to curses program */
 
     SP->key_code = TRUE;
@@ -465,7 +590,118 @@ bool PDC_check_key(void)
 
     PDC_LOG(("PDC_check_key() - returning %s\n", s ? "TRUE" : "FALSE"));
 
-    return pdc_resize_now || !!s;
+    return pdc_resize_now || !!s || _click_due();
+}
+
+/* Xt runs its timers only when asked for events, so while the cursor
+   or text is blinking, wake up every 50ms to let it */
+
+static int _wait_slice(int ms)
+{
+    if ((pdc_app_data.cursorBlinkRate || (SP->termattrs & A_BLINK)) &&
+        (ms < 0 || ms > 50))
+        ms = 50;
+
+    return ms;
+}
+
+/* PDC_wakeup() writes to this pipe to end a poll() in PDC_wait_key().
+   It's made on the first wait, and kept for the life of the process;
+   keys posted before then are seen when the wait starts. */
+
+static int wake_pipe[2] = {-1, -1};
+
+static void _make_wake_pipe(void)
+{
+    int fds[2];
+
+    if (pipe(fds) == -1)
+        return;
+
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+
+    wake_pipe[0] = fds[0];
+    wake_pipe[1] = fds[1];
+}
+
+void PDC_wakeup(void)
+{
+    char c = 0;
+
+    if (wake_pipe[1] == -1)
+        return;
+
+    /* retry if a signal interrupts the write; if the pipe is full
+       (EAGAIN), a wakeup is pending anyway */
+
+    while (write(wake_pipe[1], &c, 1) == -1 && errno == EINTR)
+        ;
+}
+
+bool PDC_wait_key(int *ms)
+{
+    unsigned long start;
+    XtInputMask s;
+    int left = *ms;
+
+    PDC_LOG(("PDC_wait_key() - called: ms=%d\n", *ms));
+
+#ifdef HAVE_POLL
+    if (wake_pipe[0] == -1)
+        _make_wake_pipe();
+#endif
+
+    start = PDC_ms_count();
+
+    for (;;)
+    {
+        s = XtAppPending(pdc_app_context);
+
+        /* run any timers that are due, without waiting for an event */
+
+        if (s & XtIMTimer)
+        {
+            XtAppProcessEvent(pdc_app_context, XtIMTimer);
+            continue;
+        }
+
+        if (*ms >= 0)
+            left = max(*ms - (int)(PDC_ms_count() - start), 0);
+
+        if (PDC_key_posted() || pdc_resize_now || s || _click_due())
+            break;
+
+        if (!left)
+            return FALSE;
+
+        XFlush(XCURSESDISPLAY);
+#ifdef HAVE_POLL
+        {
+            struct pollfd fds[2];
+            char buf[64];
+
+            fds[0].fd = ConnectionNumber(XCURSESDISPLAY);
+            fds[1].fd = wake_pipe[0];
+            fds[0].events = fds[1].events = POLLIN;
+
+            if (poll(fds, 2, _click_slice(_wait_slice(left))) > 0 &&
+                (fds[1].revents & POLLIN))
+                while (read(wake_pipe[0], buf, sizeof(buf)) > 0)
+                    ;
+        }
+#else
+        {
+            int slice = _click_slice(left);
+
+            PDC_napms((slice < 0 || slice > 10) ? 10 : slice);
+        }
+#endif
+    }
+
+    *ms = left;
+
+    return TRUE;
 }
 
 /* return the next available key or mouse event */
@@ -483,8 +719,40 @@ int PDC_get_key(void)
         return KEY_RESIZE;
     }
 
+    /* report a held press that's not going to be a click */
+
+    if (click.button)
+    {
+        bool pending = !!(XtAppPending(pdc_app_context) & XtIMXEvent);
+
+        if (pending)
+            XPeekEvent(XCURSESDISPLAY, &event);
+
+        if (_click_due() || (pending && !_click_holds(&event)))
+        {
+            SP->mouse_status = click.status;
+            SP->mouse_count = 1;
+            SP->key_time = click.stamp;
+            click.button = 0;
+
+            SP->key_code = TRUE;
+            return KEY_MOUSE;
+        }
+
+        if (!pending)
+            return -1;
+    }
+
     XtAppNextEvent(pdc_app_context, &event);
 
+    PDC_TRACE((PDC_EV_INPUT, event.type, (event.type == KeyPress ||
+               event.type == KeyRelease) ? event.xkey.keycode : 0, 0));
+
+    /* drop motion within the cell of a held press */
+
+    if (click.button && event.type == MotionNotify)
+        return -1;
+
     switch (event.type)
     {
     case KeyPress:
@@ -494,7 +762,7 @@ int PDC_get_key(void)
     case ButtonPress:
     case ButtonRelease:
     case MotionNotify:
-        newkey = _process_mouse_event(&event);
+        newkey = _process_mouse_event(&event, _coalesce(&event));
         break;
     default:
         XtDispatchEvent(&event);
@@ -525,6 +793,8 @@ void PDC_flushinp(void)
 
     while (PDC_check_key())
         PDC_get_key();
+
+    click.button = 0;
 }
 
 bool PDC_has_mouse(void)
@@ -230,6 +230,8 @@ static void _initialize_colors(void)
         pdc_color[i + 232] = RGB(i * 10 + 8, i * 10 + 8, i * 10 + 8);
 
 #undef RGB
+
+    PDC_reset_styles();
 }
 
 static void _get_icon(void)
@@ -342,6 +344,18 @@ static void _handle_expose(Widget w, XtPointer client_data, XEvent *event,
         _display_screen();
 }
 
+/* parts of the source of an XCopyArea() from PDC_copy_area() that were
+   unavailable, e.g. under another window, are reported here */
+
+static void _handle_graphics_expose(Widget w, XtPointer client_data,
+                                    XEvent *event, Boolean *unused)
+{
+    PDC_LOG(("_handle_graphics_expose() - called\n"));
+
+    if (event->type == GraphicsExpose && !event->xgraphicsexpose.count)
+        _display_screen();
+}
+
 static void _handle_nonmaskable(Widget w, XtPointer client_data, XEvent *event,
                                 Boolean *unused)
 {
@@ -484,6 +498,7 @@ int PDC_scr_open(void)
 {
     bool italic_font_valid, bold_font_valid;
     int minwidth, minheight;
+    Visual *vis;
 
     PDC_LOG(("PDC_scr_open() - called\n"));
 
@@ -591,6 +606,13 @@ int PDC_scr_open(void)
     SP->termattrs = A_COLOR | A_ITALIC | A_UNDERLINE | A_LEFT | A_RIGHT |
                     A_REVERSE;
 
+    /* PDC_RGB_COLOR() values are drawn as pixels, like the palette */
+
+    vis = DefaultVisual(XCURSESDISPLAY, DefaultScreen(XCURSESDISPLAY));
+
+    SP->rgb_color = vis->class == TrueColor && vis->red_mask == 0xff0000 &&
+                    vis->green_mask == 0xff00 && vis->blue_mask == 0xff;
+
     /* Add Event handlers to the drawing widget */
 
     XtAddEventHandler(pdc_drawing, ExposureMask, False, _handle_expose, NULL);
@@ -599,6 +621,7 @@ int PDC_scr_open(void)
     XtAddEventHandler(pdc_drawing, EnterWindowMask | LeaveWindowMask, False,
                       _handle_enter_leave, NULL);
     XtAddEventHandler(pdc_toplevel, 0, True, _handle_nonmaskable, NULL);
+    XtAddEventHandler(pdc_drawing, 0, True, _handle_graphics_expose, NULL);
 
     /* If there is a cursorBlink resource, start the Timeout event */
 
@@ -740,7 +763,10 @@ int PDC_init_color(short color, short red, short green, short blue)
                                     DefaultScreen(XCURSESDISPLAY));
 
     if (XAllocColor(XCURSESDISPLAY, cmap, &tmp))
+    {
         pdc_color[color] = tmp.pixel;
+        PDC_reset_styles();
+    }
 
     return OK;
 }
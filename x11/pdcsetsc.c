@@ -85,6 +85,8 @@ int PDC_set_blink(bool blinkon)
     else
         SP->termattrs &= ~A_BLINK;
 
+    PDC_reset_styles();
+
     return OK;
 }
 
@@ -98,5 +100,7 @@ int PDC_set_bold(bool boldon)
     else
         SP->termattrs &= ~A_BOLD;
 
+    PDC_reset_styles();
+
     return OK;
 }
@@ -6,6 +6,8 @@
 # include <poll.h>
 #endif
 
+#include <sys/time.h>
+
 void PDC_beep(void)
 {
     PDC_LOG(("PDC_beep() - called\n"));
@@ -13,6 +15,24 @@ void PDC_beep(void)
     XBell(XtDisplay(pdc_toplevel), 50);
 }
 
+unsigned long PDC_ms_count(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec * 1000UL + tv.tv_usec / 1000;
+}
+
+unsigned long PDC_us_count(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec * 1000000UL + tv.tv_usec;
+}
+
 void PDC_napms(int ms)
 {
     PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
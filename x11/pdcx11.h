@@ -79,4 +79,5 @@ void PDC_blink_cursor(XtPointer, XtIntervalId *);
 void PDC_blink_text(XtPointer, XtIntervalId *);
 int PDC_kb_setup(void);
 void PDC_redraw_cursor(void);
+void PDC_reset_styles(void);
 bool PDC_scrollbar_init(const char *);